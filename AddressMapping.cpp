@@ -29,12 +29,14 @@
 *********************************************************************************/
 #include "SystemConfiguration.h"
 #include "AddressMapping.h"
+#include "SimProfiler.h"
 
 namespace DRAMSim
 {
 
 void addressMapping(uint64_t physicalAddress, unsigned &newTransactionChan, unsigned &newTransactionRank, unsigned &newTransactionBank, unsigned &newTransactionRow, unsigned &newTransactionColumn)
 {
+	PROFILE_SCOPE(AddressMapping)
 	uint64_t tempA, tempB;
 	unsigned transactionSize = TRANSACTION_SIZE;
 	uint64_t transactionMask =  transactionSize - 1; //ex: (64 bit bus width) x (8 Burst Length) - 1 = 64 bytes - 1 = 63 = 0x3f mask
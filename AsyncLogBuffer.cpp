@@ -0,0 +1,321 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+//AsyncLogBuffer.cpp
+//
+//Class file for the stream buffer that writes log output from a background thread
+//
+
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/time.h>
+
+#include "AsyncLogBuffer.h"
+#include "PrintMacros.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+AsyncLogBuffer *AsyncLogBuffer::coutBuffer = NULL;
+streambuf *AsyncLogBuffer::savedCoutBuffer = NULL;
+unsigned AsyncLogBuffer::coutUsers = 0;
+pthread_mutex_t AsyncLogBuffer::coutLock = PTHREAD_MUTEX_INITIALIZER;
+vector<AsyncLogBuffer *> AsyncLogBuffer::live;
+pthread_mutex_t AsyncLogBuffer::liveLock = PTHREAD_MUTEX_INITIALIZER;
+bool AsyncLogBuffer::drainAtExit = false;
+
+AsyncLogBuffer::AsyncLogBuffer(streambuf *sink_, size_t bufferSize_, unsigned numBuffers_) :
+	sink(sink_),
+	bufferSize(bufferSize_),
+	current(NULL),
+	writing(false),
+	stopping(false),
+	flushDue(false)
+{
+	if (numBuffers_ < 2)
+	{
+		numBuffers_ = 2;
+	}
+	for (unsigned i=0; i<numBuffers_; i++)
+	{
+		Buffer *b = new Buffer();
+		b->data.resize(bufferSize);
+		b->length = 0;
+		buffers.push_back(b);
+		empty.push_back(b);
+	}
+
+	pthread_mutex_init(&putLock, NULL);
+	pthread_mutex_init(&lock, NULL);
+	pthread_cond_init(&fullCond, NULL);
+	pthread_cond_init(&emptyCond, NULL);
+	if (pthread_create(&writer, NULL, &AsyncLogBuffer::writerMain, this) != 0)
+	{
+		ERROR("Cannot start the log writer thread");
+		exit(-1);
+	}
+	nextBuffer();
+
+	pthread_mutex_lock(&liveLock);
+	live.push_back(this);
+	if (!drainAtExit)
+	{
+		atexit(&AsyncLogBuffer::drainAll);
+		drainAtExit = true;
+	}
+	pthread_mutex_unlock(&liveLock);
+}
+
+AsyncLogBuffer::~AsyncLogBuffer()
+{
+	pthread_mutex_lock(&liveLock);
+	for (size_t i=0; i<live.size(); i++)
+	{
+		if (live[i] == this)
+		{
+			live.erase(live.begin() + i);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&liveLock);
+
+	drain();
+
+	pthread_mutex_lock(&lock);
+	stopping = true;
+	pthread_cond_signal(&fullCond);
+	pthread_mutex_unlock(&lock);
+	pthread_join(writer, NULL);
+
+	pthread_cond_destroy(&emptyCond);
+	pthread_cond_destroy(&fullCond);
+	pthread_mutex_destroy(&lock);
+	pthread_mutex_destroy(&putLock);
+	for (size_t i=0; i<buffers.size(); i++)
+	{
+		delete buffers[i];
+	}
+}
+
+AsyncLogBuffer *AsyncLogBuffer::attachCout()
+{
+	pthread_mutex_lock(&coutLock);
+	if (coutUsers == 0)
+	{
+		coutBuffer = new AsyncLogBuffer(cout.rdbuf());
+		savedCoutBuffer = cout.rdbuf(coutBuffer);
+	}
+	coutUsers++;
+	pthread_mutex_unlock(&coutLock);
+	return coutBuffer;
+}
+
+void AsyncLogBuffer::detachCout()
+{
+	pthread_mutex_lock(&coutLock);
+	coutUsers--;
+	if (coutUsers == 0)
+	{
+		cout.rdbuf(savedCoutBuffer);
+		delete coutBuffer;
+		coutBuffer = NULL;
+	}
+	pthread_mutex_unlock(&coutLock);
+}
+
+void AsyncLogBuffer::drain()
+{
+	pthread_mutex_lock(&putLock);
+	handOff();
+
+	pthread_mutex_lock(&lock);
+	while (!full.empty() || writing)
+	{
+		pthread_cond_wait(&emptyCond, &lock);
+	}
+	pthread_mutex_unlock(&lock);
+
+	nextBuffer();
+	// the writer is idle now, so the sink can be flushed from this thread
+	sink->pubsync();
+	pthread_mutex_unlock(&putLock);
+}
+
+//drains the buffers that are still installed when the program exits
+void AsyncLogBuffer::drainAll()
+{
+	pthread_mutex_lock(&liveLock);
+	for (size_t i=0; i<live.size(); i++)
+	{
+		live[i]->drain();
+	}
+	pthread_mutex_unlock(&liveLock);
+}
+
+AsyncLogBuffer::int_type AsyncLogBuffer::overflow(int_type c)
+{
+	if (!traits_type::eq_int_type(c, traits_type::eof()))
+	{
+		char ch = traits_type::to_char_type(c);
+		pthread_mutex_lock(&putLock);
+		append(&ch, 1);
+		pthread_mutex_unlock(&putLock);
+	}
+	return traits_type::not_eof(c);
+}
+
+std::streamsize AsyncLogBuffer::xsputn(const char *s, std::streamsize n)
+{
+	pthread_mutex_lock(&putLock);
+	append(s, n);
+	pthread_mutex_unlock(&putLock);
+	return n;
+}
+
+//hands the current buffer to the writer, without waiting for it to be
+//written, if the writer asked for it
+int AsyncLogBuffer::sync()
+{
+	if (__sync_bool_compare_and_swap(&flushDue, true, false))
+	{
+		pthread_mutex_lock(&putLock);
+		handOff();
+		nextBuffer();
+		pthread_mutex_unlock(&putLock);
+	}
+	return 0;
+}
+
+// copy to the current buffer, handing it off whenever it is full (with putLock held)
+void AsyncLogBuffer::append(const char *s, size_t n)
+{
+	while (n > 0)
+	{
+		size_t room = bufferSize - current->length;
+		if (room == 0)
+		{
+			handOff();
+			nextBuffer();
+			continue;
+		}
+		size_t chunk = n < room ? n : room;
+		memcpy(&current->data[current->length], s, chunk);
+		current->length += chunk;
+		s += chunk;
+		n -= chunk;
+	}
+}
+
+// queue the current buffer for the writer if it has anything in it
+void AsyncLogBuffer::handOff()
+{
+	if (current == NULL || current->length == 0)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&lock);
+	full.push_back(current);
+	pthread_cond_signal(&fullCond);
+	pthread_mutex_unlock(&lock);
+
+	current = NULL;
+}
+
+// make sure there is a buffer to write into, waiting for the writer if all
+// of them are queued
+void AsyncLogBuffer::nextBuffer()
+{
+	if (current != NULL)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&lock);
+	while (empty.empty())
+	{
+		pthread_cond_wait(&emptyCond, &lock);
+	}
+	current = empty.back();
+	empty.pop_back();
+	pthread_mutex_unlock(&lock);
+
+	current->length = 0;
+}
+
+void *AsyncLogBuffer::writerMain(void *arg)
+{
+	((AsyncLogBuffer *)arg)->writerLoop();
+	return NULL;
+}
+
+void AsyncLogBuffer::writerLoop()
+{
+	pthread_mutex_lock(&lock);
+	while (true)
+	{
+		while (full.empty() && !stopping)
+		{
+			// when nothing came for a while, have the next flush hand off
+			// whatever is buffered
+			struct timeval now;
+			gettimeofday(&now, NULL);
+			uint64_t until = now.tv_usec * 1000ULL + FLUSH_INTERVAL_MS * 1000000ULL;
+			struct timespec deadline;
+			deadline.tv_sec = now.tv_sec + until / 1000000000ULL;
+			deadline.tv_nsec = until % 1000000000ULL;
+			if (pthread_cond_timedwait(&fullCond, &lock, &deadline) == ETIMEDOUT)
+			{
+				__sync_bool_compare_and_swap(&flushDue, false, true);
+			}
+		}
+		if (full.empty())
+		{
+			break;
+		}
+		Buffer *b = full.front();
+		full.pop_front();
+		writing = true;
+		pthread_mutex_unlock(&lock);
+
+		sink->sputn(&b->data[0], b->length);
+
+		pthread_mutex_lock(&lock);
+		writing = false;
+		empty.push_back(b);
+		pthread_cond_broadcast(&emptyCond);
+	}
+	pthread_mutex_unlock(&lock);
+}
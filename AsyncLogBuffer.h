@@ -0,0 +1,138 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+#ifndef ASYNCLOGBUFFER_H
+#define ASYNCLOGBUFFER_H
+
+//AsyncLogBuffer.h
+//
+//Header file for the stream buffer that writes log output from a background thread
+//
+
+#include <streambuf>
+#include <vector>
+#include <deque>
+#include <pthread.h>
+
+using std::streambuf;
+using std::vector;
+using std::deque;
+
+namespace DRAMSim
+{
+/*
+ * A streambuf that collects everything written to it in large private
+ * buffers and hands full buffers to a background thread, which writes them
+ * to the underlying streambuf (usually the one of the log file). The
+ * simulation thread then only ever copies bytes: formatting still happens
+ * through the usual ostream operators, but no system calls are made on the
+ * simulation thread unless the writer falls behind by more than numBuffers
+ * buffers, in which case it waits for a free one (nothing is dropped).
+ *
+ * A simulator instance that logs to its own file (LOG_OUTPUT) installs its
+ * own AsyncLogBuffer on it. std::cout is shared by all instances, so they
+ * share one AsyncLogBuffer on it, see attachCout(), which threads running
+ * separate simulations write to at the same time. The buffer therefore
+ * keeps no put area of its own (every write goes through xsputn() or
+ * overflow()) and appends to the current buffer under putLock.
+ *
+ * std::endl and flush() hand the current buffer to the writer without
+ * waiting for it, but only once the writer has been idle for
+ * FLUSH_INTERVAL_MS (PRINT() ends every line with std::endl, and handing
+ * off every line would cost more than writing it directly). The buffers
+ * still alive when the program exits (e.g. through exit() after an error)
+ * are drained from an atexit() handler, so no output is lost on the way
+ * out.
+ */
+class AsyncLogBuffer : public streambuf
+{
+public:
+	static const unsigned FLUSH_INTERVAL_MS = 100;
+
+	AsyncLogBuffer(streambuf *sink_, size_t bufferSize_=1<<20, unsigned numBuffers_=4);
+	virtual ~AsyncLogBuffer();
+
+	// write out what has been buffered so far and wait for it to complete
+	void drain();
+
+	// the first attachCout() installs an AsyncLogBuffer on std::cout and the
+	// last detachCout() writes it out and puts the original buffer back
+	static AsyncLogBuffer *attachCout();
+	static void detachCout();
+
+protected:
+	virtual int_type overflow(int_type c);
+	virtual std::streamsize xsputn(const char *s, std::streamsize n);
+	virtual int sync();
+
+private:
+	struct Buffer
+	{
+		vector<char> data;
+		size_t length;
+	};
+
+	void append(const char *s, size_t n);
+	void handOff();
+	void nextBuffer();
+	static void *writerMain(void *arg);
+	void writerLoop();
+	static void drainAll();
+
+	streambuf *sink;
+	size_t bufferSize;
+	Buffer *current;
+	vector<Buffer *> buffers;
+	deque<Buffer *> full; // waiting for the writer, in order
+	vector<Buffer *> empty;
+	bool writing; // the writer is busy with a buffer it has taken off full
+	bool stopping;
+	bool flushDue; // set by the writer when sync() should hand off current
+	pthread_mutex_t putLock; // held while writing to current
+	pthread_mutex_t lock;
+	pthread_cond_t fullCond; // signalled when a buffer is queued or on stop
+	pthread_cond_t emptyCond; // signalled when the writer returns a buffer
+	pthread_t writer;
+
+	static AsyncLogBuffer *coutBuffer;
+	static streambuf *savedCoutBuffer;
+	static unsigned coutUsers;
+	static pthread_mutex_t coutLock;
+	static vector<AsyncLogBuffer *> live; // drained at exit
+	static pthread_mutex_t liveLock; // for live and drainAtExit
+	static bool drainAtExit;
+};
+}
+
+#endif
+
@@ -0,0 +1,101 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+//BackingStore.cpp
+//
+//Class file for the memory mapped backing store of the bank data
+//
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#include "BackingStore.h"
+#include "SystemConfiguration.h"
+#include "PrintMacros.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+BackingStore::BackingStore(const string &filename_, unsigned numChannels) :
+	filename(filename_),
+	size(numChannels * NUM_RANKS * NUM_BANKS * bankSize()),
+	data(NULL)
+{
+	int fd = open(filename.c_str(), O_CREAT | O_RDWR, 0644);
+	if (fd < 0)
+	{
+		ERROR("Cannot open backing store '"<<filename<<"': "<<strerror(errno));
+		exit(-1);
+	}
+	// a larger file is left as it is, a smaller one is extended with a hole
+	struct stat st;
+	if (fstat(fd, &st) != 0 || ((uint64_t)st.st_size < size && ftruncate(fd, size) != 0))
+	{
+		ERROR("Cannot resize backing store '"<<filename<<"' to "<<size<<" bytes: "<<strerror(errno));
+		exit(-1);
+	}
+	void *mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED)
+	{
+		ERROR("Cannot map backing store '"<<filename<<"': "<<strerror(errno));
+		exit(-1);
+	}
+	data = (unsigned char *)mapping;
+}
+
+BackingStore::~BackingStore()
+{
+	if (msync(data, size, MS_SYNC) != 0)
+	{
+		ERROR("Cannot write back backing store '"<<filename<<"': "<<strerror(errno));
+	}
+	munmap(data, size);
+}
+
+//the bytes of one bank: NUM_ROWS rows of NUM_COLS>>COL_LOW_BIT_WIDTH bursts
+uint64_t BackingStore::bankSize()
+{
+	return (uint64_t)NUM_ROWS * (NUM_COLS >> COL_LOW_BIT_WIDTH) * TRANSACTION_SIZE;
+}
+
+unsigned char *BackingStore::bankData(unsigned channel, unsigned rank, unsigned bank)
+{
+	return data + ((channel * NUM_RANKS + rank) * NUM_BANKS + bank) * bankSize();
+}
+
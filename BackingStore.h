@@ -0,0 +1,85 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+#ifndef BACKINGSTORE_H
+#define BACKINGSTORE_H
+
+//BackingStore.h
+//
+//Header file for the memory mapped backing store of the bank data
+//
+
+#include <string>
+#include <stdint.h>
+#include <stddef.h>
+
+using std::string;
+
+namespace DRAMSim
+{
+/*
+ * With FUNCTIONAL_STORE set in system.ini (to a file name), the data the
+ * banks store in a build without NO_STORAGE is kept in that file rather
+ * than in the pages of each bank. The file is an image of the whole memory
+ * in the order of the decoded address:
+ *
+ *   channel, rank, bank, row, column (one TRANSACTION_SIZE burst each)
+ *
+ * so the bytes of a burst are at
+ *
+ *   ((((channel*NUM_RANKS + rank)*NUM_BANKS + bank)*NUM_ROWS + row)*(NUM_COLS>>COL_LOW_BIT_WIDTH) + column)*TRANSACTION_SIZE
+ *
+ * The file is mapped shared and grown sparse, so only what is written takes
+ * up memory and disk space, even for a memory of many GB. Whatever the file
+ * already holds is the initial content of the memory (unwritten parts of a
+ * new file read as zeros), and it holds the final content once the memory
+ * system is deleted; neither needs a copy.
+ */
+class BackingStore
+{
+public:
+	BackingStore(const string &filename, unsigned numChannels);
+	~BackingStore();
+
+	unsigned char *bankData(unsigned channel, unsigned rank, unsigned bank);
+	static uint64_t bankSize();
+
+private:
+	string filename;
+	size_t size;
+	unsigned char *data;
+};
+}
+
+#endif
+
@@ -35,66 +35,180 @@
 
 #include "Bank.h"
 #include "BusPacket.h"
+#include <cstdlib>
+#include <cstring>
 
 using namespace std;
 using namespace DRAMSim;
 
+static const unsigned PAGE_BURSTS = 16; // per page
+static const unsigned PAGES_PER_CHUNK = 64;
+
+//what reads of unwritten data return, shared by all banks; it is never
+//written, so it is set up statically rather than on first use
+static const size_t ZERO_PAGE_SIZE = 4096;
+static const unsigned char zeroPage[ZERO_PAGE_SIZE] = {0};
+
 Bank::Bank(ostream &dramsim_log_):
 		currentState(dramsim_log_), 
-		rowEntries(NUM_COLS),
+		pagesUsed(0),
+		pagesLeftInChunk(0),
+		backingData(NULL),
 		dramsim_log(dramsim_log_)
-{}
+{
+	if (TRANSACTION_SIZE > ZERO_PAGE_SIZE)
+	{
+		ERROR("== Error - Transactions of "<<TRANSACTION_SIZE<<" bytes are too large to store");
+		abort();
+	}
+}
+
+//only empty banks are copied (when the rank makes its vector of banks)
+Bank::Bank(const Bank &other):
+		currentState(other.currentState),
+		pagesUsed(0),
+		pagesLeftInChunk(0),
+		backingData(other.backingData),
+		dramsim_log(other.dramsim_log)
+{
+	if (other.pagesUsed > 0)
+	{
+		ERROR("== Error - Cannot copy a bank that holds data");
+		abort();
+	}
+}
+
+Bank::~Bank()
+{
+	for (size_t i=0; i<chunks.size(); i++)
+	{
+		free(chunks[i]);
+	}
+}
 
 /* The bank class is just a glorified sparse storage data structure
  * that keeps track of written data in case the simulator wants a
  * function DRAM model
  *
- * A vector of size NUM_COLS keeps a linked list of rows and their
- * associated values.
+ * The data is kept in pages of PAGE_BURSTS consecutive columns (bursts of
+ * TRANSACTION_SIZE bytes) of a row, which are found through a hash table
+ * indexed by row and page, so a lookup takes the same time however much
+ * has been written. The pages are cut from large chunks of memory that
+ * are only freed with the bank, and a page is only allocated once
+ * something is written to it.
+ *
+ * write() copies the data into its page, allocating the page on the first
+ * write to it, and frees the write's buffer, which the bank has always
+ * taken over
  *
- * write() adds an entry to the proper linked list or replaces the
- * 	value in a row that was already written
+ * read() returns a pointer into the page, or if nothing was written to the
+ * 	page, to a zero page shared by all banks; unwritten columns of a
+ * 	written page are zero as well. The pointer stays valid as long as the
+ * 	bank.
  *
- * read() searches for a node with the right row value, if not found
- * 	returns the tracer value 0xDEADBEEF
- * 
- *	TODO: if anyone wants to actually store data, see the 'data_storage' branch and perhaps try to merge that into master
+ * With a BackingStore (FUNCTIONAL_STORE), the data is kept in the bank's
+ * part of the mapped file instead, and read() points straight into it;
+ * unwritten data reads as zeros there too (unless the image says otherwise).
  */
 
+unsigned char *Bank::allocatePage()
+{
+	size_t pageSize = PAGE_BURSTS * TRANSACTION_SIZE;
+	if (pagesLeftInChunk == 0)
+	{
+		chunks.push_back((unsigned char *)calloc(PAGES_PER_CHUNK, pageSize));
+		pagesLeftInChunk = PAGES_PER_CHUNK;
+	}
+	unsigned char *page = chunks.back() + (PAGES_PER_CHUNK - pagesLeftInChunk) * pageSize;
+	pagesLeftInChunk--;
+	return page;
+}
+
+//doubles the page table, which is kept at most half full
+void Bank::growPageTable()
+{
+	vector<PageEntry> old;
+	old.swap(pageTable);
+	PageEntry empty = {0, NULL};
+	pageTable.assign(old.empty() ? 64 : old.size() * 2, empty);
+	size_t mask = pageTable.size() - 1;
+	for (size_t i=0; i<old.size(); i++)
+	{
+		if (old[i].key != 0)
+		{
+			size_t slot = (old[i].key * 0x9E3779B97F4A7C15ULL >> 20) & mask;
+			while (pageTable[slot].key != 0)
+			{
+				slot = (slot + 1) & mask;
+			}
+			pageTable[slot] = old[i];
+		}
+	}
+}
 
+//keep the data in data, NUM_ROWS rows of NUM_COLS>>COL_LOW_BIT_WIDTH bursts
+void Bank::setBackingStore(unsigned char *data)
+{
+	backingData = data;
+}
 
-Bank::DataStruct *Bank::searchForRow(unsigned row, DataStruct *head)
+//the page holding column of row, or NULL if it was never written and create is false
+unsigned char *Bank::findPage(unsigned row, unsigned column, bool create)
 {
-	while (head != NULL)
+	if (pageTable.empty())
 	{
-		if (head->row == row)
+		if (!create)
 		{
-			//found it
-			return head;
+			return NULL;
 		}
-		//keep looking
-		head = head->next;
+		growPageTable();
+	}
+	uint64_t key = (((uint64_t)row << 32) | (column / PAGE_BURSTS)) + 1;
+	size_t mask = pageTable.size() - 1;
+	size_t slot = (key * 0x9E3779B97F4A7C15ULL >> 20) & mask;
+	while (pageTable[slot].key != 0)
+	{
+		if (pageTable[slot].key == key)
+		{
+			return pageTable[slot].page;
+		}
+		slot = (slot + 1) & mask;
+	}
+	if (!create)
+	{
+		return NULL;
+	}
+
+	if (2 * (pagesUsed + 1) > pageTable.size())
+	{
+		growPageTable();
+		return findPage(row, column, create);
 	}
-	//if we get here, didn't find it
-	return NULL;
+	pageTable[slot].key = key;
+	pageTable[slot].page = allocatePage();
+	pagesUsed++;
+	return pageTable[slot].page;
 }
 
 void Bank::read(BusPacket *busPacket)
 {
-	DataStruct *rowHeadNode = rowEntries[busPacket->column];
-	DataStruct *foundNode = NULL;
+	if (backingData != NULL)
+	{
+		busPacket->data = backingData + ((uint64_t)busPacket->row * (NUM_COLS >> COL_LOW_BIT_WIDTH) + busPacket->column) * TRANSACTION_SIZE;
+		busPacket->busPacketType = DATA;
+		return;
+	}
 
-	if ((foundNode = Bank::searchForRow(busPacket->row, rowHeadNode)) == NULL)
+	unsigned char *page = findPage(busPacket->row, busPacket->column, false);
+	if (page == NULL)
 	{
-		// the row hasn't been written before, so it isn't in the list
+		// the row hasn't been written before
 		//if(SHOW_SIM_OUTPUT) DEBUG("== Warning - Read from previously unwritten row " << busPacket->row);
-		void *garbage = calloc(BL * (JEDEC_DATA_BUS_BITS/8),1);
-		((long *)garbage)[0] = 0xdeadbeef; // tracer value
-		busPacket->data = garbage;
+		busPacket->data = (void *)zeroPage;
 	}
 	else // found it
 	{
-		busPacket->data = foundNode->data;
+		busPacket->data = page + (busPacket->column % PAGE_BURSTS) * TRANSACTION_SIZE;
 	}
 
 	//the return packet should be a data packet, not a read packet
@@ -113,32 +227,30 @@ void Bank::write(const BusPacket *busPacket)
 		exit(-1);
 	}
 
-	// head of the list we need to search
-	DataStruct *rowHeadNode = rowEntries[busPacket->column];
-	DataStruct *foundNode = NULL;
-
-	if ((foundNode = Bank::searchForRow(busPacket->row, rowHeadNode)) == NULL)
+	unsigned char *data;
+	if (backingData != NULL)
 	{
-		//not found
-		DataStruct *newRowNode = (DataStruct *)malloc(sizeof(DataStruct));
-
-		//insert at the head for speed
-		//TODO: Optimize this data structure for speedier lookups?
-		newRowNode->row = busPacket->row;
-		newRowNode->data = busPacket->data;
-		newRowNode->next = rowHeadNode;
-		rowEntries[busPacket->column] = newRowNode;
+		data = backingData + ((uint64_t)busPacket->row * (NUM_COLS >> COL_LOW_BIT_WIDTH) + busPacket->column) * TRANSACTION_SIZE;
 	}
 	else
 	{
-		// found it, just plaster in the new data
-		foundNode->data = busPacket->data;
-		if (DEBUG_BANKS)
-		{
-			PRINTN(" -- Bank "<<busPacket->bank<<" writing to physical address 0x" << hex << busPacket->physicalAddress<<dec<<":");
-			busPacket->printData();
-			PRINT("");
-		}
+		data = findPage(busPacket->row, busPacket->column, true) + (busPacket->column % PAGE_BURSTS) * TRANSACTION_SIZE;
+	}
+	if (DEBUG_BANKS)
+	{
+		PRINTN(" -- Bank "<<busPacket->bank<<" writing to physical address 0x" << hex << busPacket->physicalAddress<<dec<<":");
+		busPacket->printData();
+		PRINT("");
+	}
+	if (busPacket->data != NULL)
+	{
+		memcpy(data, busPacket->data, TRANSACTION_SIZE);
+		// only free the write's buffer once it isn't needed anymore
+		free(busPacket->data);
+	}
+	else
+	{
+		memset(data, 0, TRANSACTION_SIZE);
 	}
 }
 
@@ -48,33 +48,46 @@
 #include "BankState.h"
 #include "BusPacket.h"
 #include <iostream>
+#include <vector>
+#include <stdint.h>
 
 namespace DRAMSim
 {
 class Bank
 {
-	typedef struct _DataStruct
+	//an entry of the page table: the row and page within the row (plus
+	//one, so that 0 means empty) and where the page is in the arena
+	typedef struct _PageEntry
 	{
-		unsigned row;
-		void *data;
-		struct _DataStruct *next;
-	} DataStruct;
+		uint64_t key;
+		unsigned char *page;
+	} PageEntry;
 
 public:
 	//functions
 	Bank(ostream &dramsim_log_);
+	Bank(const Bank &other);
+	~Bank();
 	void read(BusPacket *busPacket);
 	void write(const BusPacket *busPacket);
+	void setBackingStore(unsigned char *data);
 
 	//fields
 	BankState currentState;
 
 private:
 	// private member
-	std::vector<DataStruct *> rowEntries;
+	std::vector<PageEntry> pageTable; // open addressing, a power of two in size
+	size_t pagesUsed;
+	std::vector<unsigned char *> chunks; // the arena the pages are cut from
+	size_t pagesLeftInChunk;
+	unsigned char *backingData; // this bank's part of the BackingStore, or NULL
 	ostream &dramsim_log; 
 
-	static DataStruct *searchForRow(unsigned row, DataStruct *head);
+	unsigned char *findPage(unsigned row, unsigned column, bool create);
+	unsigned char *allocatePage();
+	void growPageTable();
+	Bank &operator=(const Bank &);
 };
 }
 
@@ -41,6 +41,7 @@
 //
 
 #include "BankState.h"
+#include "Checkpoint.h"
 
 using namespace std;
 using namespace DRAMSim;
@@ -86,3 +87,16 @@ void BankState::print()
 	PRINT("    nextPrecharge  : " << nextPrecharge );
 	PRINT("    nextPowerUp    : " << nextPowerUp );
 }
+
+void BankState::checkpoint(Checkpoint &cp)
+{
+	cp.io(currentBankState);
+	cp.io(openRowAddress);
+	cp.io(nextRead);
+	cp.io(nextWrite);
+	cp.io(nextActivate);
+	cp.io(nextPrecharge);
+	cp.io(nextPowerUp);
+	cp.io(lastCommand);
+	cp.io(stateChangeCountdown);
+}
@@ -48,6 +48,8 @@
 
 namespace DRAMSim
 {
+class Checkpoint;
+
 enum CurrentBankState
 {
 	Idle,
@@ -76,6 +78,7 @@ public:
 	//Functions
 	BankState(ostream &dramsim_log_);
 	void print();
+	void checkpoint(Checkpoint &cp);
 };
 }
 
@@ -0,0 +1,73 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+//BusLog.cpp
+//
+//Class file for the binary log of bus traffic
+//
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "BusLog.h"
+#include "PrintMacros.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+BusLog::BusLog(const string &filename) :
+	buffer(NULL)
+{
+	file.open(filename.c_str(), ios_base::out | ios_base::trunc | ios_base::binary);
+	if (!file)
+	{
+		ERROR("Cannot open '"<<filename<<"'");
+		exit(-1);
+	}
+
+	BusLogHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, "DRAMBUSL", sizeof(header.magic));
+	header.version = 1;
+	header.recordSize = sizeof(BusLogRecord);
+	file.write((const char *)&header, sizeof(header));
+
+	buffer = new AsyncLogBuffer(file.rdbuf());
+}
+
+BusLog::~BusLog()
+{
+	// writes out the last records before the file is closed
+	delete buffer;
+	file.close();
+}
@@ -0,0 +1,123 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+#ifndef BUSLOG_H
+#define BUSLOG_H
+
+//BusLog.h
+//
+//Header file for the binary log of bus traffic
+//
+
+#include <fstream>
+#include <string>
+#include <stdint.h>
+
+#include "AsyncLogBuffer.h"
+#include "BusPacket.h"
+
+using std::ofstream;
+using std::string;
+
+namespace DRAMSim
+{
+/*
+ * With BUS_LOG=true in system.ini, every packet that DEBUG_BUS would print
+ * is written to dramsim[.N].buslog as a fixed size binary record instead,
+ * through an AsyncLogBuffer. This costs a few stores per command, so the
+ * log can stay enabled for long runs (also in a release build, where
+ * DEBUG_BUS is compiled out); buslog_decode.py turns it back into the
+ * DEBUG_BUS text, with the cycle and channel of each packet in front.
+ *
+ * The file is a BusLogHeader followed by BusLogRecords, in host byte order.
+ */
+struct BusLogHeader
+{
+	char magic[8]; // "DRAMBUSL"
+	uint32_t version;
+	uint32_t recordSize;
+};
+
+struct BusLogRecord
+{
+	uint64_t cycle;
+	uint64_t physicalAddress;
+	uint32_t row;
+	uint32_t column;
+	uint16_t bank;
+	uint8_t rank;
+	uint8_t channel;
+	uint8_t event; // BusLog::Event
+	uint8_t busPacketType; // BusPacketType
+	uint16_t reserved;
+};
+
+class BusLog
+{
+public:
+	enum Event
+	{
+		MCCommandIssue,
+		MCDataIssue,
+		MCDataReceive,
+		RankReceive, // the rank is in BusLogRecord::rank
+		RankDataIssue
+	};
+
+	BusLog(const string &filename);
+	~BusLog();
+
+	void record(Event event, unsigned channel, uint64_t cycle, const BusPacket *packet)
+	{
+		BusLogRecord r;
+		r.cycle = cycle;
+		r.physicalAddress = packet->physicalAddress;
+		r.row = packet->row;
+		r.column = packet->column;
+		r.bank = packet->bank;
+		r.rank = packet->rank;
+		r.channel = channel;
+		r.event = event;
+		r.busPacketType = packet->busPacketType;
+		r.reserved = 0;
+		buffer->sputn((const char *)&r, sizeof(r));
+	}
+
+private:
+	ofstream file;
+	AsyncLogBuffer *buffer;
+};
+}
+
+#endif
+
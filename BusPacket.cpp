@@ -55,7 +55,10 @@ BusPacket::BusPacket(BusPacketType packtype, uint64_t physicalAddr,
 	bank(b),
 	rank(r),
 	physicalAddress(physicalAddr),
-	data(dat)
+	data(dat),
+	transaction(NULL),
+	timeAdded(0),
+	tag(0)
 {}
 
 void BusPacket::print(uint64_t currentClockCycle, bool dataStart)
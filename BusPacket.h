@@ -39,6 +39,8 @@
 
 namespace DRAMSim
 {
+class Transaction;
+
 enum BusPacketType
 {
 	READ,
@@ -64,6 +66,11 @@ public:
 	unsigned rank;
 	uint64_t physicalAddress;
 	void *data;
+	//the read that this ACT or CAS was made for (only with LATENCY_BREAKDOWN)
+	Transaction *transaction;
+	//when the transaction of a CAS (and of its write data) was added
+	uint64_t timeAdded;
+	uint64_t tag; // of that transaction
 
 	//Functions
 	BusPacket(BusPacketType packtype, uint64_t physicalAddr, unsigned col, unsigned rw, unsigned r, unsigned b, void *dat, ostream &dramsim_log_);
@@ -0,0 +1,291 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+//Checkpoint.cpp
+//
+//Class file for checkpoints of the simulator state
+//
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Checkpoint.h"
+#include "PrintMacros.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+Checkpoint::Checkpoint(const string &filename_, bool saving_) :
+	filename(filename_),
+	saving(saving_)
+{
+	file = fopen(filename.c_str(), saving ? "wb" : "rb");
+	if (file == NULL)
+	{
+		ERROR("Cannot open '"<<filename<<"'");
+		exit(-1);
+	}
+	section("DRAMCKPT");
+	uint32_t version = 4;
+	io(version);
+	if (version != 4)
+	{
+		ERROR("'"<<filename<<"' has unsupported checkpoint version "<<version);
+		exit(-1);
+	}
+}
+
+Checkpoint::~Checkpoint()
+{
+	if (saving && (fflush(file) != 0 || ferror(file)))
+	{
+		ERROR("Error writing '"<<filename<<"'");
+		exit(-1);
+	}
+	fclose(file);
+}
+
+void Checkpoint::write(const void *data, size_t size)
+{
+	fwrite(data, 1, size, file);
+}
+
+void Checkpoint::read(void *data, size_t size)
+{
+	if (fread(data, 1, size, file) != size)
+	{
+		ERROR("'"<<filename<<"' is truncated");
+		exit(-1);
+	}
+}
+
+void Checkpoint::section(const char *tag)
+{
+	size_t length = strlen(tag);
+	if (saving)
+	{
+		write(tag, length);
+	}
+	else
+	{
+		vector<char> found(length);
+		read(&found[0], length);
+		if (memcmp(&found[0], tag, length) != 0)
+		{
+			ERROR("'"<<filename<<"' is not a checkpoint of this memory system (expected "<<tag<<")");
+			exit(-1);
+		}
+	}
+}
+
+void Checkpoint::io(uint64_t &value)
+{
+	if (saving)
+	{
+		uint8_t bytes[10];
+		size_t length = 0;
+		uint64_t v = value;
+		while (v >= 0x80)
+		{
+			bytes[length++] = (uint8_t)(v | 0x80);
+			v >>= 7;
+		}
+		bytes[length++] = (uint8_t)v;
+		write(bytes, length);
+	}
+	else
+	{
+		value = 0;
+		for (unsigned shift=0; ; shift+=7)
+		{
+			uint8_t byte;
+			read(&byte, 1);
+			if (shift > 63)
+			{
+				ERROR("'"<<filename<<"' is corrupt");
+				exit(-1);
+			}
+			value |= (uint64_t)(byte & 0x7f) << shift;
+			if (byte < 0x80)
+			{
+				break;
+			}
+		}
+	}
+}
+
+void Checkpoint::io(unsigned &value)
+{
+	uint64_t wide = value;
+	io(wide);
+	value = (unsigned)wide;
+}
+
+//for containers whose size is fixed by the configuration
+void Checkpoint::checkSize(size_t size)
+{
+	uint64_t saved = size;
+	io(saved);
+	if (saved != size)
+	{
+		ERROR("'"<<filename<<"' is a checkpoint of a differently configured memory system");
+		exit(-1);
+	}
+}
+
+void Checkpoint::io(vector<bool> &values)
+{
+	uint64_t size = values.size();
+	io(size);
+	if (!saving)
+	{
+		values.resize(size);
+	}
+	for (size_t i=0; i<values.size(); i++)
+	{
+		uint8_t value = values[i];
+		io(value);
+		values[i] = value;
+	}
+}
+
+void Checkpoint::io(Transaction *&trans)
+{
+	uint8_t present = trans != NULL;
+	io(present);
+	if (!present)
+	{
+		trans = NULL;
+		return;
+	}
+	if (saving)
+	{
+		uint64_t number = transactionNumbers.size();
+		transactionNumbers[trans] = number;
+	}
+	else
+	{
+		trans = new Transaction(DATA_READ, 0, NULL);
+		transactions.push_back(trans);
+	}
+	io(trans->transactionType);
+	io(trans->address);
+	io(trans->timeAdded);
+	io(trans->timeReturned);
+	io(trans->tag);
+	io(trans->timeCommandQueued);
+	io(trans->timeActivated);
+	io(trans->timeCASIssued);
+	io(trans->refreshCycles);
+	io(trans->prechargeCycles);
+	io(trans->addressMapped);
+	io(trans->channel);
+	io(trans->rank);
+	io(trans->bank);
+	io(trans->row);
+	io(trans->column);
+}
+
+void Checkpoint::io(deque<Transaction *> &transactions)
+{
+	uint64_t size = transactions.size();
+	io(size);
+	if (!saving)
+	{
+		transactions.resize(size);
+	}
+	for (size_t i=0; i<transactions.size(); i++)
+	{
+		io(transactions[i]);
+	}
+}
+
+void Checkpoint::io(BusPacket *&packet, ostream &dramsim_log)
+{
+	uint8_t present = packet != NULL;
+	io(present);
+	if (!present)
+	{
+		packet = NULL;
+		return;
+	}
+	if (!saving)
+	{
+		packet = new BusPacket(DATA, 0, 0, 0, 0, 0, NULL, dramsim_log);
+	}
+	io(packet->busPacketType);
+	io(packet->column);
+	io(packet->row);
+	io(packet->bank);
+	io(packet->rank);
+	io(packet->physicalAddress);
+	io(packet->timeAdded);
+	io(packet->tag);
+
+	//the transaction by number, 0 for none
+	uint64_t number = 0;
+	if (saving && packet->transaction != NULL)
+	{
+		map<const Transaction *, uint64_t>::const_iterator it = transactionNumbers.find(packet->transaction);
+		if (it == transactionNumbers.end())
+		{
+			ERROR("A bus packet points to a transaction that is not in the checkpoint");
+			abort();
+		}
+		number = it->second + 1;
+	}
+	io(number);
+	if (!saving)
+	{
+		if (number > transactions.size())
+		{
+			ERROR("'"<<filename<<"' is corrupt");
+			exit(-1);
+		}
+		packet->transaction = number > 0 ? transactions[number - 1] : NULL;
+	}
+}
+
+void Checkpoint::io(vector<BusPacket *> &packets, ostream &dramsim_log)
+{
+	uint64_t size = packets.size();
+	io(size);
+	if (!saving)
+	{
+		packets.resize(size);
+	}
+	for (size_t i=0; i<packets.size(); i++)
+	{
+		io(packets[i], dramsim_log);
+	}
+}
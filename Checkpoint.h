@@ -0,0 +1,138 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+//Checkpoint.h
+//
+//Header file for checkpoints of the simulator state
+//
+
+#include <stdio.h>
+#include <stdint.h>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "BusPacket.h"
+#include "Transaction.h"
+
+using std::deque;
+using std::map;
+using std::string;
+using std::vector;
+
+namespace DRAMSim
+{
+/*
+ * A binary checkpoint of the state of a memory system (see
+ * MultiChannelMemorySystem::saveCheckpoint()). The same checkpoint(cp)
+ * function of each class writes its state when saving and reads it back
+ * when restoring, so the two can't get out of step: io(x) does either,
+ * depending on the direction of the Checkpoint. section() puts a tag
+ * between the parts so that a checkpoint from a different build or
+ * configuration is caught instead of silently misread.
+ *
+ * Unsigned integers are written as LEB128 varints (like in a CommandTrace),
+ * which keeps the many small counters and queue entries compact; all other
+ * values are written as they are in memory. Transactions and bus packets
+ * are written by value. A bus packet can point
+ * at the read it was made for (LATENCY_BREAKDOWN), so every transaction
+ * gets a number as it is written and packets refer to their transaction by
+ * that number; the owners of the transactions have to be written before
+ * the packets that point to them. 
+ */
+class Checkpoint
+{
+public:
+	Checkpoint(const string &filename, bool saving);
+	~Checkpoint();
+
+	bool isSaving() const { return saving; }
+	void section(const char *tag);
+
+	//plain values: integers, floats, enums and structs without pointers
+	void io(uint64_t &value);
+	void io(unsigned &value);
+
+	template <typename T>
+	void io(T &value)
+	{
+		if (saving)
+		{
+			write(&value, sizeof(value));
+		}
+		else
+		{
+			read(&value, sizeof(value));
+		}
+	}
+
+	template <typename T>
+	void io(vector<T> &values)
+	{
+		uint64_t size = values.size();
+		io(size);
+		if (!saving)
+		{
+			values.resize(size);
+		}
+		for (size_t i=0; i<values.size(); i++)
+		{
+			io(values[i]);
+		}
+	}
+
+	void checkSize(size_t size);
+	void io(vector<bool> &values);
+	void io(Transaction *&trans);
+	void io(deque<Transaction *> &transactions);
+	void io(BusPacket *&packet, ostream &dramsim_log);
+	void io(vector<BusPacket *> &packets, ostream &dramsim_log);
+
+private:
+	void write(const void *data, size_t size);
+	void read(void *data, size_t size);
+
+	string filename;
+	FILE *file;
+	bool saving;
+	map<const Transaction *, uint64_t> transactionNumbers; // saving
+	vector<Transaction *> transactions; // restoring, by number
+};
+}
+
+#endif
+
@@ -12,48 +12,56 @@ namespace ClockDomain
 	{
 	}
 	ClockDomainCrosser::ClockDomainCrosser(uint64_t _clock1, uint64_t _clock2, ClockUpdateCB *_callback) 
-		: callback(_callback), clock1(_clock1), clock2(_clock2), counter1(0), counter2(0)
+		: callback(_callback), counter1(0), counter2(0)
 	{
+		setClocks(_clock1, _clock2);
 		//cout << "CTOR: callback address: " << (uint64_t)(this->callback) << "\t ratio="<<clock1<<"/"<<clock2<< endl;
 	}
 
+	// The ratio is turned into a fraction by expanding it as a continued
+	// fraction until it matches the double or the denominator would pass 2^32
 	ClockDomainCrosser::ClockDomainCrosser(double ratio, ClockUpdateCB *_callback)
 		: callback(_callback), counter1(0), counter2(0)
 	{
-		// Compute numerator and denominator for ratio, then pass that to other constructor.
-		double x = ratio;
-
-		const int MAX_ITER = 15;
-		size_t i;
-		unsigned ns[MAX_ITER], ds[MAX_ITER];
-		double zs[MAX_ITER];
-		ds[0] = 0;
-		ds[1] = 1;
-		zs[1] = x;
-		ns[1] = (int)x; 
-
-		for (i = 1; i<MAX_ITER-1; i++)
+		// convergents n/d, starting from 1/0 and 0/1
+		uint64_t n0 = 1, d0 = 0, n1 = (uint64_t)floor(ratio), d1 = 1;
+		double z = ratio - floor(ratio);
+		while (z > 0 && fabs(ratio - (double)n1/d1) > 1e-12 * ratio)
 		{
-			if (fabs(x - (double)ns[i]/(double)ds[i]) < 0.00005)
+			z = 1.0 / z;
+			uint64_t a = (uint64_t)floor(z);
+			z -= a;
+			if (a > ((1ULL << 32) - d0) / d1)
 			{
-				//printf("ANSWER= %u/%d\n",ns[i],ds[i]);
 				break;
 			}
-			//TODO: or, if the answers are the same as the last iteration, stop 
-
-			zs[i+1] = 1.0f/(zs[i]-(int)floor(zs[i])); // 1/(fractional part of z_i)
-			ds[i+1] = ds[i]*(int)floor(zs[i+1])+ds[i-1];
-			double tmp = x*ds[i+1];
-			double tmp2 = tmp - (int)tmp;
-			ns[i+1] = tmp2 >= 0.5 ? ceil(tmp) : floor(tmp); // ghetto implementation of a rounding function
-			//printf("i=%lu, z=%20f n=%5u d=%5u\n",i,zs[i],ns[i],ds[i]);
+			uint64_t n2 = a*n1 + n0, d2 = a*d1 + d0;
+			n0 = n1; d0 = d1;
+			n1 = n2; d1 = d2;
 		}
+		setClocks(n1, d1);
+	}
 
-		//printf("APPROXIMATION= %u/%d\n",ns[i],ds[i]);
-		this->clock1=ns[i];
-		this->clock2=ds[i];
+	static uint64_t gcd(uint64_t a, uint64_t b)
+	{
+		while (b != 0)
+		{
+			uint64_t t = a % b;
+			a = b;
+			b = t;
+		}
+		return a;
+	}
 
-		//cout << "CTOR: callback address: " << (uint64_t)(this->callback) << "\t ratio="<<clock1<<"/"<<clock2<< endl;
+	// The clocks only matter as a ratio, which is kept exact and reduced so
+	// that the counters stay small
+	void ClockDomainCrosser::setClocks(uint64_t _clock1, uint64_t _clock2)
+	{
+		uint64_t divisor = gcd(_clock1, _clock2);
+		clock1 = _clock1 / divisor;
+		clock2 = _clock2 / divisor;
+		counter1 = 0;
+		counter2 = 0;
 	}
 
 	void ClockDomainCrosser::update()
@@ -80,14 +88,44 @@ namespace ClockDomain
 			}
 		}
 
-		if (counter1 == counter2)
+		// only the difference matters, so keep them from growing forever
+		counter2 -= counter1;
+		counter1 = 0;
+	}
+
+	// How many times update() would call the callback in the next cycles
+	// calls, without changing anything
+	uint64_t ClockDomainCrosser::ticks(uint64_t cycles) const
+	{
+		if (clock1 == clock2)
+		{
+			return cycles;
+		}
+		// counter1 + clock1*cycles can take more than 64 bits
+		unsigned __int128 target = (unsigned __int128)counter1 + (unsigned __int128)clock1 * cycles;
+		if (target <= counter2)
 		{
-			counter1 = 0;
-			counter2 = 0;
+			return 0;
 		}
+		return (uint64_t)((target - counter2 + clock2 - 1) / clock2);
 	}
 
+	// Same as calling update() cycles times, except that the callback is not
+	// called: returns how many times it would have been, so that the caller
+	// can run its clock directly. 
+	uint64_t ClockDomainCrosser::advance(uint64_t cycles)
+	{
+		if (clock1 == clock2)
+		{
+			return cycles;
+		}
 
+		uint64_t n = ticks(cycles);
+		unsigned __int128 target = (unsigned __int128)counter1 + (unsigned __int128)clock1 * cycles;
+		counter2 = (uint64_t)((unsigned __int128)counter2 + (unsigned __int128)n * clock2 - target);
+		counter1 = 0;
+		return n;
+	}
 
 	void TestObj::cb()
 	{
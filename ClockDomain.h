@@ -47,7 +47,10 @@ namespace ClockDomain
 		ClockDomainCrosser(ClockUpdateCB *_callback);
 		ClockDomainCrosser(uint64_t _clock1, uint64_t _clock2, ClockUpdateCB *_callback);
 		ClockDomainCrosser(double ratio, ClockUpdateCB *_callback);
+		void setClocks(uint64_t _clock1, uint64_t _clock2);
 		void update();
+		uint64_t ticks(uint64_t cycles) const;
+		uint64_t advance(uint64_t cycles);
 	};
 
 
@@ -42,6 +42,8 @@
 
 #include "CommandQueue.h"
 #include "MemoryController.h"
+#include "SimProfiler.h"
+#include "Checkpoint.h"
 #include <assert.h>
 
 using namespace DRAMSim;
@@ -163,6 +165,7 @@ void CommandQueue::enqueue(BusPacket *newBusPacket)
 //command scheduling policy
 bool CommandQueue::pop(BusPacket **busPacket)
 {
+	PROFILE_SCOPE(CommandQueuePop)
 	//this can be done here because pop() is called every clock cycle by the parent MemoryController
 	//	figures out the sliding window requirement for tFAW
 	//
@@ -711,6 +714,20 @@ bool CommandQueue::isEmpty(unsigned rank)
 	}
 }
 
+//checks whether any command is still waiting to go to a particular bank
+bool CommandQueue::hasCommandsFor(unsigned rank, unsigned bank)
+{
+	vector<BusPacket *> &queue = getCommandQueue(rank, bank);
+	for (size_t i=0;i<queue.size();i++)
+	{
+		if (queue[i]->bank == bank)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 //tells the command queue that a particular rank is in need of a refresh
 void CommandQueue::needRefresh(unsigned rank)
 {
@@ -718,6 +735,21 @@ void CommandQueue::needRefresh(unsigned rank)
 	refreshRank = rank;
 }
 
+//skips ahead without simulating the cycles in between; the queues must be empty
+void CommandQueue::fastForward(uint64_t cycles)
+{
+	currentClockCycle += cycles;
+	for (size_t i=0;i<NUM_RANKS;i++)
+	{
+		//any activates in the tFAW window are long gone
+		tFAWCountdown[i].clear();
+		for (size_t j=0;j<NUM_BANKS;j++)
+		{
+			rowAccessCounters[i][j] = 0;
+		}
+	}
+}
+
 void CommandQueue::nextRankAndBank(unsigned &rank, unsigned &bank)
 {
 	if (schedulingPolicy == RankThenBankRoundRobin)
@@ -761,3 +793,27 @@ void CommandQueue::update()
 	//needed for SimulatorObject
 	//TODO: make CommandQueue not a SimulatorObject
 }
+
+//the queued commands and the scheduling state (the bank states belong to the controller)
+void CommandQueue::checkpoint(Checkpoint &cp)
+{
+	cp.io(currentClockCycle);
+	cp.checkSize(queues.size());
+	for (size_t i=0; i<queues.size(); i++)
+	{
+		cp.checkSize(queues[i].size());
+		for (size_t j=0; j<queues[i].size(); j++)
+		{
+			cp.io(queues[i][j], dramsim_log);
+		}
+	}
+	cp.io(nextBank);
+	cp.io(nextRank);
+	cp.io(nextBankPRE);
+	cp.io(nextRankPRE);
+	cp.io(refreshRank);
+	cp.io(refreshWaiting);
+	cp.io(tFAWCountdown);
+	cp.io(rowAccessCounters);
+	cp.io(sendAct);
+}
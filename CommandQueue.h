@@ -51,6 +51,8 @@ using namespace std;
 
 namespace DRAMSim
 {
+class Checkpoint;
+
 class CommandQueue : public SimulatorObject
 {
 	CommandQueue();
@@ -70,7 +72,10 @@ public:
 	bool hasRoomFor(unsigned numberToEnqueue, unsigned rank, unsigned bank);
 	bool isIssuable(BusPacket *busPacket);
 	bool isEmpty(unsigned rank);
+	bool hasCommandsFor(unsigned rank, unsigned bank);
 	void needRefresh(unsigned rank);
+	void fastForward(uint64_t cycles);
+	void checkpoint(Checkpoint &cp);
 	void print();
 	void update(); //SimulatorObject requirement
 	vector<BusPacket *> &getCommandQueue(unsigned rank, unsigned bank);
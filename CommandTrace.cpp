@@ -0,0 +1,108 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+//CommandTrace.cpp
+//
+//Class file for the binary trace of the DRAM commands issued on a channel
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "CommandTrace.h"
+#include "PrintMacros.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+CommandTrace::CommandTrace(const string &filename_, unsigned channel, CommandTraceFormat format) :
+	filename(filename_),
+	file(NULL),
+	isPipe(false),
+	length(0),
+	lastCycle(0)
+{
+	if (format == GzipCommandTrace)
+	{
+		string command = "gzip -c > '" + filename + "'";
+		file = popen(command.c_str(), "w");
+		isPipe = true;
+	}
+	else
+	{
+		file = fopen(filename.c_str(), "wb");
+	}
+	if (file == NULL)
+	{
+		ERROR("Cannot open '"<<filename<<"'");
+		exit(-1);
+	}
+
+	memcpy(buffer, "DRAMCMDT", 8);
+	length = 8;
+	putVarint(1);
+	putVarint(channel);
+	putVarint((uint64_t)floor(tCK * 1000 + 0.5));
+}
+
+CommandTrace::~CommandTrace()
+{
+	flush();
+	if (isPipe)
+	{
+		if (pclose(file) != 0)
+		{
+			ERROR("gzip failed while writing '"<<filename<<"'");
+		}
+	}
+	else
+	{
+		fclose(file);
+	}
+}
+
+const char *CommandTrace::extension(CommandTraceFormat format)
+{
+	return format == GzipCommandTrace ? ".cmdtrace.gz" : ".cmdtrace";
+}
+
+void CommandTrace::flush()
+{
+	if (length > 0 && fwrite(buffer, 1, length, file) != length)
+	{
+		ERROR("Cannot write to '"<<filename<<"'");
+		exit(-1);
+	}
+	length = 0;
+}
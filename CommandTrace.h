@@ -0,0 +1,122 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+#ifndef COMMANDTRACE_H
+#define COMMANDTRACE_H
+
+//CommandTrace.h
+//
+//Header file for the binary trace of the DRAM commands issued on a channel
+//
+
+#include <stdio.h>
+#include <string>
+#include <stdint.h>
+
+#include "BusPacket.h"
+#include "SystemConfiguration.h"
+
+using std::string;
+
+namespace DRAMSim
+{
+/*
+ * With COMMAND_TRACE=raw or gzip in system.ini, every command a memory
+ * controller puts on the command bus is written to a file per channel,
+ * dramsim[.SIM_DESC].chN.cmdtrace (or .cmdtrace.gz). Unlike
+ * VERIFICATION_OUTPUT, which writes one text file for all channels, this
+ * is compact enough to capture the full command stream of long runs;
+ * cmdtrace_read.py prints or summarizes it.
+ *
+ * All integers are unsigned LEB128 varints (7 bits per byte, least
+ * significant first, high bit set on all but the last byte). The file is
+ *
+ *   "DRAMCMDT" version channel tCK_ps
+ *
+ * followed by one record per command:
+ *
+ *   cycles_since_previous_command type rank bank row column
+ *
+ * where type is a single byte holding the BusPacketType. The first delta is
+ * counted from cycle 0. gzip compression is done by a gzip process that
+ * the trace is piped through, so it runs in parallel to the simulation.
+ */
+class CommandTrace
+{
+public:
+	CommandTrace(const string &filename, unsigned channel, CommandTraceFormat format);
+	~CommandTrace();
+
+	static const char *extension(CommandTraceFormat format);
+
+	void record(uint64_t cycle, const BusPacket *packet)
+	{
+		if (length + MAX_RECORD_SIZE > BUFFER_SIZE)
+		{
+			flush();
+		}
+		putVarint(cycle - lastCycle);
+		lastCycle = cycle;
+		buffer[length++] = (unsigned char)packet->busPacketType;
+		putVarint(packet->rank);
+		putVarint(packet->bank);
+		putVarint(packet->row);
+		putVarint(packet->column);
+	}
+
+private:
+	static const size_t BUFFER_SIZE = 1<<16;
+	static const size_t MAX_RECORD_SIZE = 10 + 1 + 4*5;
+
+	void putVarint(uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			buffer[length++] = (unsigned char)(value | 0x80);
+			value >>= 7;
+		}
+		buffer[length++] = (unsigned char)value;
+	}
+	void flush();
+
+	string filename;
+	FILE *file;
+	bool isPipe;
+	unsigned char buffer[BUFFER_SIZE];
+	size_t length;
+	uint64_t lastCycle;
+};
+}
+
+#endif
+
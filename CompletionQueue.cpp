@@ -0,0 +1,105 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+//CompletionQueue.cpp
+//
+//Class file for the queue of completed transactions
+//
+
+#include "CompletionQueue.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+CompletionQueue::CompletionQueue(unsigned blockSize_) :
+	blockSize(blockSize_ > 0 ? blockSize_ : 1),
+	readPosition(0)
+{
+	writeBlock = readBlock = new Block(blockSize);
+}
+
+CompletionQueue::~CompletionQueue()
+{
+	while (readBlock != NULL)
+	{
+		Block *next = readBlock->next;
+		delete readBlock;
+		readBlock = next;
+	}
+}
+
+//the current block is full (simulator side)
+void CompletionQueue::addBlock()
+{
+	Block *block = new Block(blockSize);
+	__sync_synchronize();
+	writeBlock->next = block;
+	writeBlock = block;
+}
+
+//copy up to max completions to out and return how many (consumer side)
+unsigned CompletionQueue::pop(Completion *out, unsigned max)
+{
+	unsigned popped = 0;
+	while (popped < max)
+	{
+		unsigned available = readBlock->count;
+		__sync_synchronize();
+		if (readPosition < available)
+		{
+			unsigned count = available - readPosition;
+			if (count > max - popped)
+			{
+				count = max - popped;
+			}
+			for (unsigned i=0; i<count; i++)
+			{
+				out[popped++] = readBlock->entries[readPosition++];
+			}
+		}
+		else if (readPosition == blockSize && readBlock->next != NULL)
+		{
+			//the producer has moved on to the next block, this one is done
+			__sync_synchronize();
+			Block *next = readBlock->next;
+			delete readBlock;
+			readBlock = next;
+			readPosition = 0;
+		}
+		else
+		{
+			break;
+		}
+	}
+	return popped;
+}
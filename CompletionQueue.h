@@ -0,0 +1,110 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+#ifndef COMPLETIONQUEUE_H
+#define COMPLETIONQUEUE_H
+
+//CompletionQueue.h
+//
+//Header file for the queue of completed transactions
+//
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace DRAMSim
+{
+//a finished read or write, as handed to the caller by drainCompletions()
+struct Completion
+{
+	uint64_t address;
+	uint64_t cycle; // memory clock cycle at which it completed
+	uint64_t latency; // memory clock cycles since it was added
+	uint64_t tag; // as given to addTransaction() or submitTransaction(), 0 if none
+	unsigned channel;
+	bool isWrite;
+};
+
+/*
+ * Optional replacement for the read and write callbacks: instead of calling
+ * into the CPU simulator from the middle of MemoryController::update(), the
+ * completions are queued and the CPU simulator drains them in batches
+ * whenever it suits it. There is one producer (the thread that calls
+ * update()) and one consumer (the thread that calls pop()), which may be
+ * different threads, and no locks: every field is only written by one side.
+ *
+ * The simulator never waits for the consumer and never drops completions,
+ * so the queue is a list of fixed size blocks rather than a single ring. The
+ * producer links in a new block when the last one is full and the consumer
+ * frees the blocks it has emptied; with a block size that covers the
+ * completions between two drains, there is only ever one block.
+ */
+class CompletionQueue
+{
+public:
+	CompletionQueue(unsigned blockSize);
+	~CompletionQueue();
+
+	void push(const Completion &completion)
+	{
+		if (writeBlock->count == blockSize)
+		{
+			addBlock();
+		}
+		writeBlock->entries[writeBlock->count] = completion;
+		//the entry has to be visible before the count that publishes it
+		__sync_synchronize();
+		writeBlock->count = writeBlock->count + 1;
+	}
+	unsigned pop(Completion *out, unsigned max);
+
+private:
+	struct Block
+	{
+		Block(unsigned size) : entries(size), count(0), next(NULL) {}
+		std::vector<Completion> entries;
+		volatile unsigned count; // written by the producer
+		Block * volatile next; // written by the producer once the block is full
+	};
+	void addBlock();
+
+	unsigned blockSize;
+	Block *writeBlock; // producer side
+	Block *readBlock; // consumer side
+	unsigned readPosition; // consumer side, within readBlock
+};
+}
+
+#endif
+
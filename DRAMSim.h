@@ -36,6 +36,7 @@
  * provide all necessary functionality to talk to an external simulator
  */
 #include "Callback.h"
+#include "CompletionQueue.h"
 #include <string>
 using std::string;
 
@@ -45,8 +46,21 @@ namespace DRAMSim
 	class MultiChannelMemorySystem {
 		public: 
 			bool addTransaction(bool isWrite, uint64_t addr);
+			bool addTransaction(bool isWrite, uint64_t addr, uint64_t tag);
+			unsigned addTransactions(const bool *isWrite, const uint64_t *addrs, unsigned count, bool *accepted=NULL);
+			unsigned addTransactions(const bool *isWrite, const uint64_t *addrs, const uint64_t *tags, unsigned count, bool *accepted=NULL);
 			void setCPUClockSpeed(uint64_t cpuClkFreqHz);
 			void update();
+			void update(uint64_t cycles);
+			uint64_t runUntilNextEvent(uint64_t maxCycles);
+			void enableCompletionQueue(unsigned entries);
+			unsigned drainCompletions(Completion *out, unsigned max);
+			void enableSubmissionQueues(unsigned entries);
+			bool submitTransaction(bool isWrite, uint64_t addr);
+			bool submitTransaction(bool isWrite, uint64_t addr, uint64_t tag);
+			void saveCheckpoint(const std::string &filename);
+			void restoreCheckpoint(const std::string &filename);
+			void setFastMode(bool fast);
 			void printStats(bool finalStats);
 			bool willAcceptTransaction(); 
 			bool willAcceptTransaction(uint64_t addr); 
@@ -0,0 +1,107 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+//DetailedPowerModel.cpp
+//
+//Class file for the per-command, per-state DRAM power model
+//
+
+#include "DetailedPowerModel.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+DetailedPowerModel::DetailedPowerModel(unsigned numRanks_) :
+	PowerModel(numRanks_)
+{
+	activateEnergy = deviceEnergy((double)IDD0 - IDD3N, IPP0 - IPP3N, tRAS);
+	prechargeEnergy = deviceEnergy((double)IDD0 - IDD2N, IPP0 - IPP2N, tRC - tRAS);
+	readEnergy = deviceEnergy((double)IDD4R - IDD3N, IPP4R - IPP3N, BL/2.0);
+	writeEnergy = deviceEnergy((double)IDD4W - IDD3N, IPP4W - IPP3N, BL/2.0);
+	refreshEnergy = deviceEnergy((double)IDD5 - IDD3N, IPP5 - IPP3N, tRFC);
+}
+
+double DetailedPowerModel::deviceEnergy(double iDD, double iPP, double cycles) const
+{
+	return (iDD * Vdd + iPP * Vpp) * cycles * tCK * NUM_DEVICES;
+}
+
+void DetailedPowerModel::command(unsigned rank, BusPacketType type)
+{
+	switch (type)
+	{
+	case READ_P:
+		energy[rank].actpre += prechargeEnergy;
+		//fall through
+	case READ:
+		energy[rank].burst += readEnergy;
+		break;
+	case WRITE_P:
+		energy[rank].actpre += prechargeEnergy;
+		//fall through
+	case WRITE:
+		energy[rank].burst += writeEnergy;
+		break;
+	case ACTIVATE:
+		energy[rank].actpre += activateEnergy;
+		break;
+	case PRECHARGE:
+		energy[rank].actpre += prechargeEnergy;
+		break;
+	case REFRESH:
+		energy[rank].refresh += refreshEnergy;
+		break;
+	default:
+		break;
+	}
+}
+
+double DetailedPowerModel::backgroundEnergy(RankState state, unsigned openBanks) const
+{
+	switch (state)
+	{
+	case ActiveStandby:
+	{
+		double open = (double)openBanks / NUM_BANKS;
+		return deviceEnergy(IDD2N + open * ((double)IDD3N - IDD2N), IPP2N + open * (IPP3N - IPP2N), 1);
+	}
+	case ActivePowerDown:
+		return deviceEnergy(IDD3Pf, IPP3P, 1);
+	case PrechargePowerDown:
+		return deviceEnergy(IDD2P, IPP2P, 1);
+	case SelfRefresh:
+		return deviceEnergy(IDD6, IPP6, 1);
+	default:
+		return deviceEnergy(IDD2N, IPP2N, 1);
+	}
+}
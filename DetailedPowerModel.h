@@ -0,0 +1,83 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+#ifndef DETAILEDPOWERMODEL_H
+#define DETAILEDPOWERMODEL_H
+
+//DetailedPowerModel.h
+//
+//Header file for the per-command, per-state DRAM power model
+//
+
+#include "PowerModel.h"
+
+namespace DRAMSim
+{
+/*
+ * A DRAMPower-style model (POWER_MODEL=detailed). Activates and
+ * precharges (including the implicit precharge of READ_P/WRITE_P) are
+ * charged separately, as IDD0 above IDD3N for tRAS and IDD0 above IDD2N
+ * for tRC-tRAS. The background current depends on the rank state: IDD2N
+ * to IDD3N in proportion to the number of open banks in standby, IDD3Pf in
+ * active and IDD2P in precharge power down, IDD6 in self refresh. The
+ * corresponding IPP currents at Vpp are added for DDR4 devices that list
+ * them in the device ini file.
+ *
+ * IDD1 and IDD7 aren't needed since the mixes of commands they measure are
+ * built up from the individual commands, and IDD2Q/IDD3Ps/IDD6L describe
+ * modes the memory controller never uses.
+ */
+class DetailedPowerModel : public PowerModel
+{
+public:
+	DetailedPowerModel(unsigned numRanks_);
+
+	virtual void command(unsigned rank, BusPacketType type);
+
+protected:
+	virtual double backgroundEnergy(RankState state, unsigned openBanks) const;
+
+private:
+	// energy of all devices drawing iDD from Vdd and iPP from Vpp for the given cycles
+	double deviceEnergy(double iDD, double iPP, double cycles) const;
+
+	double activateEnergy;
+	double prechargeEnergy;
+	double readEnergy;
+	double writeEnergy;
+	double refreshEnergy;
+};
+}
+
+#endif
+
@@ -0,0 +1,369 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+//FastMemoryModel.cpp
+//
+//Class file for the analytical (fast) model of a channel
+//
+
+#include "FastMemoryModel.h"
+#include "MemorySystem.h"
+#include "AddressMapping.h"
+#include "CompletionQueue.h"
+#include <algorithm>
+
+using namespace DRAMSim;
+using namespace std;
+
+FastMemoryModel::FastMemoryModel(MemorySystem *parent, ostream &dramsim_log_) :
+		dramsim_log(dramsim_log_),
+		completedTransactions(0),
+		latencies(HISTOGRAM_PRECISION),
+		parentMemorySystem(parent),
+		dataBus(DATA_BUS_WINDOW, 0),
+		dataBusStart(0),
+		reads(0),
+		writes(0),
+		totalReadLatency(0),
+		rowHits(0),
+		rowMisses(0),
+		rowConflicts(0)
+{
+	Bank bank = {false, 0, 0, 0, 0, 0};
+	banks.assign(NUM_RANKS*NUM_BANKS, bank);
+	for (size_t i=0; i<NUM_RANKS; i++)
+	{
+		//staggered like the detailed model's refreshes
+		ranks.push_back(Rank());
+		ranks.back().nextRefresh = (uint64_t)((REFRESH_PERIOD/tCK)/NUM_RANKS)*(i+1);
+	}
+}
+
+//a refresh closes all the rows of the rank and blocks it for tRFC
+void FastMemoryModel::refresh(unsigned rank, uint64_t cycle)
+{
+	Rank &r = ranks[rank];
+	while (cycle >= r.nextRefresh)
+	{
+		for (size_t j=0; j<NUM_BANKS; j++)
+		{
+			Bank &b = banks[rank*NUM_BANKS+j];
+			uint64_t start = max(r.nextRefresh, b.rowOpen ? b.nextPrecharge + tRP : b.nextActivate);
+			b.rowOpen = false;
+			b.nextActivate = max(b.nextActivate, start + tRFC);
+		}
+		r.nextRefresh += (uint64_t)(REFRESH_PERIOD/tCK);
+	}
+}
+
+/*
+	Finds the first cycle from earliest on at which the rank can activate a
+	row, at least tRRD away from its other activates and with no four of
+	them within tFAW, and reserves it. Activates are reserved out of order,
+	as requests to different banks get to that point at different times.
+*/
+uint64_t FastMemoryModel::reserveActivate(unsigned rank, uint64_t earliest, uint64_t currentClockCycle)
+{
+	deque<uint64_t> &activates = ranks[rank].activates;
+	while (!activates.empty() && activates.front() + tFAW + tRRD < currentClockCycle)
+	{
+		activates.pop_front();
+	}
+
+	uint64_t activate = earliest;
+	while (true)
+	{
+		deque<uint64_t>::iterator next = upper_bound(activates.begin(), activates.end(), activate);
+		size_t position = next - activates.begin();
+		if (next != activates.end() && *next < activate + tRRD)
+		{
+			activate = *next + tRRD;
+			continue;
+		}
+		if (position > 0 && activates[position-1] + tRRD > activate)
+		{
+			activate = activates[position-1] + tRRD;
+			continue;
+		}
+		//check every four consecutive activates that include this one; if
+		//it is the last of them it has to wait for tFAW after the first,
+		//otherwise it has to move past one of the others
+		uint64_t later = activate;
+		for (size_t first=(position >= 3 ? position-3 : 0); first<=position && first+3<=activates.size(); first++)
+		{
+			uint64_t firstCycle = first == position ? activate : activates[first];
+			uint64_t lastCycle = first+3 == position ? activate : activates[first+2];
+			if (lastCycle - firstCycle < tFAW)
+			{
+				later = max(later, first+3 == position ? firstCycle + tFAW : activate + 1);
+			}
+		}
+		if (later == activate)
+		{
+			break;
+		}
+		activate = later;
+	}
+	activates.insert(upper_bound(activates.begin(), activates.end(), activate), activate);
+	return activate;
+}
+
+/*
+	The cycles the data bus has to be idle between a burst of use and a
+	following one of next: tRTRS to switch ranks or from reading to writing,
+	tWTR plus the read latency from writing to reading in the same rank.
+*/
+uint64_t FastMemoryModel::turnaround(unsigned char use, unsigned char next)
+{
+	unsigned useRank = (use - 1) / 2, nextRank = (next - 1) / 2;
+	bool useWrites = (use - 1) % 2 == 1, nextWrites = (next - 1) % 2 == 1;
+	if (useRank != nextRank || (!useWrites && nextWrites))
+	{
+		return tRTRS;
+	}
+	if (useWrites && !nextWrites)
+	{
+		return tWTR + RL;
+	}
+	return 0;
+}
+
+/*
+	Finds the first gap on the data bus from cycle earliest on that fits a
+	burst, with the turnarounds to the bursts before and after it, and
+	reserves it. Returns the cycle the burst starts.
+*/
+uint64_t FastMemoryModel::reserveDataBus(uint64_t earliest, unsigned rank, bool isWrite, uint64_t currentClockCycle)
+{
+	//forget the bursts that are too old to matter
+	uint64_t keep = currentClockCycle > DATA_BUS_HISTORY ? currentClockCycle - DATA_BUS_HISTORY : 0;
+	if (keep >= dataBusStart + DATA_BUS_WINDOW)
+	{
+		dataBus.assign(DATA_BUS_WINDOW, 0);
+	}
+	else
+	{
+		for (uint64_t c=dataBusStart; c<keep; c++)
+		{
+			dataBus[c % DATA_BUS_WINDOW] = 0;
+		}
+	}
+	dataBusStart = max(dataBusStart, keep);
+
+	unsigned char use = 1 + rank*2 + isWrite;
+	uint64_t maxTurnaround = max((uint64_t)tRTRS, (uint64_t)(tWTR + RL));
+	uint64_t start = earliest;
+	while (true)
+	{
+		if (start + BL/2 + maxTurnaround >= dataBusStart + DATA_BUS_WINDOW)
+		{
+			//too far ahead to tell, which only happens when the bus is
+			//hopelessly overloaded anyway
+			return start;
+		}
+		uint64_t later = start;
+		for (uint64_t c=max(start, dataBusStart + maxTurnaround) - maxTurnaround; c<start + BL/2 + maxTurnaround; c++)
+		{
+			unsigned char other = dataBus[c % DATA_BUS_WINDOW];
+			if (other == 0)
+			{
+				continue;
+			}
+			if (c < start && c + 1 + turnaround(other, use) > start)
+			{
+				later = max(later, c + 1 + turnaround(other, use));
+			}
+			else if (c >= start && c < start + BL/2 + turnaround(use, other))
+			{
+				later = max(later, c + 1);
+			}
+		}
+		if (later == start)
+		{
+			break;
+		}
+		start = later;
+	}
+	for (uint64_t c=start; c<start + BL/2; c++)
+	{
+		dataBus[c % DATA_BUS_WINDOW] = use;
+	}
+	return start;
+}
+
+/*
+	Schedules the commands of a request right away, after everything that
+	was scheduled before it, and remembers when its data burst ends. The
+	transaction is deleted; without NO_STORAGE, the data of a write is
+	stored in the bank (or backing store) of the detailed model first.
+*/
+bool FastMemoryModel::addTransaction(Transaction *trans, uint64_t currentClockCycle)
+{
+	if (!willAcceptTransaction())
+	{
+		return false;
+	}
+	trans->mapAddress();
+	bool isWrite = trans->transactionType == DATA_WRITE;
+	unsigned rank = trans->rank;
+	Bank &b = banks[rank*NUM_BANKS+trans->bank];
+	Rank &r = ranks[rank];
+
+	//the controller takes the request on the next cycle
+	uint64_t cycle = currentClockCycle + 1;
+	refresh(rank, cycle);
+
+	uint64_t column;
+	if (b.rowOpen && b.openRow == trans->row)
+	{
+		rowHits++;
+		column = cycle;
+	}
+	else
+	{
+		uint64_t activate = cycle;
+		if (b.rowOpen)
+		{
+			rowConflicts++;
+			activate = max(cycle, b.nextPrecharge) + tRP;
+		}
+		else
+		{
+			rowMisses++;
+		}
+		activate = max(activate, b.nextActivate);
+		if (activate >= r.nextRefresh)
+		{
+			//the refresh comes first
+			refresh(rank, activate);
+			activate = max(activate, b.nextActivate);
+		}
+		activate = reserveActivate(rank, activate, currentClockCycle);
+
+		b.rowOpen = true;
+		b.openRow = trans->row;
+		b.openAddress = trans->address;
+		b.nextActivate = activate + tRC;
+		b.nextPrecharge = activate + tRAS;
+		column = activate + tRCD;
+	}
+	column = max(column, b.nextColumn);
+
+	uint64_t dataStart = reserveDataBus(column + (isWrite ? WL : RL), rank, isWrite, currentClockCycle);
+	column = dataStart - (isWrite ? WL : RL);
+
+	b.nextColumn = column + max(tCCD, BL/2);
+	if (rowBufferPolicy == ClosePage)
+	{
+		b.rowOpen = false;
+		b.nextActivate = max(b.nextActivate, column + (isWrite ? WRITE_AUTOPRE_DELAY : READ_AUTOPRE_DELAY));
+	}
+	else
+	{
+		b.nextPrecharge = max(b.nextPrecharge, column + (isWrite ? WRITE_TO_PRE_DELAY : READ_TO_PRE_DELAY));
+	}
+
+	Request request = {dataStart + BL/2, currentClockCycle, trans->address, trans->tag, isWrite};
+	inFlight.push(request);
+#ifndef NO_STORAGE
+	//the data is stored right away, the bank takes over the write buffer
+	if (isWrite)
+	{
+		BusPacket packet(WRITE, trans->address, trans->column, trans->row, rank, trans->bank, trans->data, dramsim_log);
+		(*parentMemorySystem->ranks)[rank]->banks[trans->bank].write(&packet);
+		trans->data = NULL;
+	}
+#endif
+	delete trans;
+	return true;
+}
+
+//completes the requests whose data burst is over
+void FastMemoryModel::update(uint64_t currentClockCycle)
+{
+	while (!inFlight.empty() && inFlight.top().doneCycle <= currentClockCycle)
+	{
+		Request request = inFlight.top();
+		inFlight.pop();
+		uint64_t latency = currentClockCycle - request.timeAdded;
+		completedTransactions++;
+		if (request.isWrite)
+		{
+			writes++;
+		}
+		else
+		{
+			reads++;
+			totalReadLatency += latency;
+			latencies.insert(latency);
+		}
+
+		CompletionQueue *completionQueue = parentMemorySystem->memoryController->completionQueue;
+		if (completionQueue != NULL)
+		{
+			Completion completion = {request.address, currentClockCycle, latency, request.tag, parentMemorySystem->systemID, request.isWrite};
+			completionQueue->push(completion);
+		}
+		Callback_t *callback = request.isWrite ? parentMemorySystem->WriteDataDone : parentMemorySystem->ReturnReadData;
+		if (callback != NULL)
+		{
+			(*callback)(parentMemorySystem->systemID, request.address, currentClockCycle);
+		}
+	}
+}
+
+//leaves the rows that are open here open in the detailed model as well
+void FastMemoryModel::openRows(MemoryController *memoryController) const
+{
+	for (size_t i=0; i<banks.size(); i++)
+	{
+		if (banks[i].rowOpen)
+		{
+			memoryController->functionalAccess(banks[i].openAddress);
+		}
+	}
+}
+
+void FastMemoryModel::printStats()
+{
+	PRINT("   Fast model : reads="<<reads<<" writes="<<writes<<" average read latency="<<(reads > 0 ? (double)totalReadLatency / reads : 0.0)
+			<<" cycles p99="<<latencies.percentile(99.0)<<" max="<<latencies.max()<<" cycles");
+	PRINT("   Fast model : row hits="<<rowHits<<" misses="<<rowMisses<<" conflicts="<<rowConflicts);
+}
+
+void FastMemoryModel::resetStats()
+{
+	reads = writes = totalReadLatency = 0;
+	rowHits = rowMisses = rowConflicts = 0;
+}
+
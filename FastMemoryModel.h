@@ -0,0 +1,155 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+#ifndef FASTMEMORYMODEL_H
+#define FASTMEMORYMODEL_H
+
+//FastMemoryModel.h
+//
+//Header file for the analytical (fast) model of a channel
+//
+
+#include "SystemConfiguration.h"
+#include "Transaction.h"
+#include "LatencyHistogram.h"
+#include <vector>
+#include <queue>
+#include <deque>
+#include <functional>
+
+namespace DRAMSim
+{
+using std::ostream;
+using std::vector;
+using std::deque;
+using std::priority_queue;
+using std::greater;
+
+class MemorySystem;
+class MemoryController;
+
+/*
+ * An approximate model of one channel for when cycle accuracy is not
+ * needed (MEMORY_MODEL=fast, or MultiChannelMemorySystem::setFastMode()).
+ * Instead of queueing commands and ticking the banks every cycle, every
+ * request is scheduled when it arrives, in order: the open row of its
+ * bank decides between a row hit, miss or conflict, and the device timings
+ * (tRCD, tRP, tRAS, tRC, tRRD, tFAW, CL, WL, tCCD, tWR, tRTP, refresh)
+ * place its commands after the ones already scheduled on the same bank and
+ * rank. Its data burst then takes the first gap on the data bus that is
+ * long enough, including the read/write turnaround (tRTRS, tWTR). The time
+ * a request waits for all of these is its queueing delay, and the data bus
+ * caps the bandwidth. The request simply completes once its burst is over,
+ * with the same callbacks and completion queue as the detailed model.
+ *
+ * Requests to a bank are served in order (there is no FR-FCFS), the
+ * command bus is not modeled and neither are the controller's queues
+ * beyond a limit of TRANS_QUEUE_DEPTH requests in flight, so latencies
+ * under load differ from the detailed model's. The per-epoch statistics and power
+ * of the vis file only cover the detailed model.
+ */
+class FastMemoryModel
+{
+	ostream &dramsim_log;
+public:
+	FastMemoryModel(MemorySystem *parent, ostream &dramsim_log_);
+
+	bool willAcceptTransaction() const
+	{
+		return inFlight.size() < TRANS_QUEUE_DEPTH;
+	}
+	bool isIdle() const
+	{
+		return inFlight.empty();
+	}
+	bool addTransaction(Transaction *trans, uint64_t currentClockCycle);
+	void update(uint64_t currentClockCycle);
+	void openRows(MemoryController *memoryController) const;
+	void printStats();
+	void resetStats();
+
+	uint64_t completedTransactions; // read returns and write completions, never reset
+	LatencyHistogram latencies; // read latencies, like MemoryController::getLatencyHistogram()
+
+private:
+	struct Bank
+	{
+		bool rowOpen;
+		unsigned openRow;
+		uint64_t openAddress; // of the request that opened the row
+		uint64_t nextActivate;
+		uint64_t nextPrecharge;
+		uint64_t nextColumn; // read or write
+	};
+	struct Rank
+	{
+		deque<uint64_t> activates; // the recent and scheduled ones, in order
+		uint64_t nextRefresh;
+	};
+	struct Request
+	{
+		uint64_t doneCycle;
+		uint64_t timeAdded;
+		uint64_t address;
+		uint64_t tag;
+		bool isWrite;
+		bool operator>(const Request &other) const
+		{
+			return doneCycle > other.doneCycle;
+		}
+	};
+
+	static const uint64_t DATA_BUS_WINDOW = 4096;
+	static const uint64_t DATA_BUS_HISTORY = 64; // cycles kept before the current one
+
+	void refresh(unsigned rank, uint64_t cycle);
+	uint64_t reserveActivate(unsigned rank, uint64_t earliest, uint64_t currentClockCycle);
+	static uint64_t turnaround(unsigned char use, unsigned char next);
+	uint64_t reserveDataBus(uint64_t earliest, unsigned rank, bool isWrite, uint64_t currentClockCycle);
+
+	MemorySystem *parentMemorySystem;
+	vector<Bank> banks; // rank*NUM_BANKS+bank
+	vector<Rank> ranks;
+	//what the data bus does in each of the cycles from dataBusStart on,
+	//modulo DATA_BUS_WINDOW: 0 if idle, else 1 + rank*2 + (1 if writing)
+	vector<unsigned char> dataBus;
+	uint64_t dataBusStart;
+	priority_queue<Request, vector<Request>, greater<Request> > inFlight;
+
+	uint64_t reads, writes, totalReadLatency;
+	uint64_t rowHits, rowMisses, rowConflicts;
+};
+}
+
+#endif
+
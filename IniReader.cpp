@@ -39,6 +39,19 @@
 
 using namespace std;
 
+#ifdef RELEASE_BUILD
+// the debug flags are constants everywhere else in a release build; they are
+// still read into variables here so that ini files which set them stay valid
+#undef VERIFICATION_OUTPUT
+#undef DEBUG_TRANS_Q
+#undef DEBUG_CMD_Q
+#undef DEBUG_ADDR_MAP
+#undef DEBUG_BANKSTATE
+#undef DEBUG_BUS
+#undef DEBUG_BANKS
+#undef DEBUG_POWER
+#endif
+
 // these are the values that are extern'd in SystemConfig.h so that they
 // have global scope even though they are set by IniReader
 
@@ -94,6 +107,18 @@ unsigned IDD6;
 unsigned IDD6L;
 unsigned IDD7;
 
+//DDR4 VPP currents, not in older device files
+float IPP0=0;
+float IPP2N=0;
+float IPP2P=0;
+float IPP3N=0;
+float IPP3P=0;
+float IPP4R=0;
+float IPP4W=0;
+float IPP5=0;
+float IPP6=0;
+float Vpp=0;
+
 
 //in bytes
 unsigned JEDEC_DATA_BUS_BITS;
@@ -113,6 +138,12 @@ string ROW_BUFFER_POLICY;
 string SCHEDULING_POLICY;
 string ADDRESS_MAPPING_SCHEME;
 string QUEUING_STRUCTURE;
+string VIS_FILE_FORMAT;
+string LIVE_STATS_SHM;
+string COMMAND_TRACE;
+string POWER_MODEL;
+string MEMORY_MODEL;
+string FUNCTIONAL_STORE;
 
 bool DEBUG_TRANS_Q;
 bool DEBUG_CMD_Q;
@@ -126,6 +157,15 @@ bool VIS_FILE_OUTPUT;
 
 bool VERIFICATION_OUTPUT;
 
+//latency histograms
+unsigned HISTOGRAM_PRECISION=5;
+bool PER_BANK_LATENCY_HISTOGRAMS;
+bool LATENCY_BREAKDOWN;
+
+//logging
+bool ASYNC_LOG;
+bool BUS_LOG;
+
 bool DEBUG_INI_READER=false;
 
 namespace DRAMSim
@@ -134,6 +174,10 @@ RowBufferPolicy rowBufferPolicy;
 SchedulingPolicy schedulingPolicy;
 AddressMappingScheme addressMappingScheme;
 QueuingStructure queuingStructure;
+VisFileFormat visFileFormat;
+CommandTraceFormat commandTraceFormat;
+PowerModelType powerModelType;
+MemoryModelType memoryModelType;
 
 
 //Map the string names to the variables they set
@@ -179,6 +223,16 @@ static ConfigMap configMap[] =
 	DEFINE_UINT_PARAM(IDD6L,DEV_PARAM),
 	DEFINE_UINT_PARAM(IDD7,DEV_PARAM),
 	DEFINE_FLOAT_PARAM(Vdd,DEV_PARAM),
+	DEFINE_OPTIONAL_FLOAT_PARAM(IPP0,DEV_PARAM),
+	DEFINE_OPTIONAL_FLOAT_PARAM(IPP2N,DEV_PARAM),
+	DEFINE_OPTIONAL_FLOAT_PARAM(IPP2P,DEV_PARAM),
+	DEFINE_OPTIONAL_FLOAT_PARAM(IPP3N,DEV_PARAM),
+	DEFINE_OPTIONAL_FLOAT_PARAM(IPP3P,DEV_PARAM),
+	DEFINE_OPTIONAL_FLOAT_PARAM(IPP4R,DEV_PARAM),
+	DEFINE_OPTIONAL_FLOAT_PARAM(IPP4W,DEV_PARAM),
+	DEFINE_OPTIONAL_FLOAT_PARAM(IPP5,DEV_PARAM),
+	DEFINE_OPTIONAL_FLOAT_PARAM(IPP6,DEV_PARAM),
+	DEFINE_OPTIONAL_FLOAT_PARAM(Vpp,DEV_PARAM),
 
 	DEFINE_UINT_PARAM(NUM_CHANS,SYS_PARAM),
 	DEFINE_UINT_PARAM(JEDEC_DATA_BUS_BITS,SYS_PARAM),
@@ -205,8 +259,19 @@ static ConfigMap configMap[] =
 	DEFINE_BOOL_PARAM(DEBUG_BANKS,SYS_PARAM),
 	DEFINE_BOOL_PARAM(DEBUG_POWER,SYS_PARAM),
 	DEFINE_BOOL_PARAM(VIS_FILE_OUTPUT,SYS_PARAM),
+	DEFINE_STRING_PARAM(VIS_FILE_FORMAT,SYS_PARAM),
+	DEFINE_STRING_PARAM(LIVE_STATS_SHM,SYS_PARAM),
+	DEFINE_STRING_PARAM(COMMAND_TRACE,SYS_PARAM),
+	DEFINE_STRING_PARAM(POWER_MODEL,SYS_PARAM),
+	DEFINE_STRING_PARAM(MEMORY_MODEL,SYS_PARAM),
+	DEFINE_STRING_PARAM(FUNCTIONAL_STORE,SYS_PARAM),
 	DEFINE_BOOL_PARAM(VERIFICATION_OUTPUT,SYS_PARAM),
-	{"", NULL, UINT, SYS_PARAM, false} // tracer value to signify end of list; if you delete it, epic fail will result
+	DEFINE_OPTIONAL_UINT_PARAM(HISTOGRAM_PRECISION,SYS_PARAM),
+	DEFINE_BOOL_PARAM(PER_BANK_LATENCY_HISTOGRAMS,SYS_PARAM),
+	DEFINE_BOOL_PARAM(LATENCY_BREAKDOWN,SYS_PARAM),
+	DEFINE_BOOL_PARAM(ASYNC_LOG,SYS_PARAM),
+	DEFINE_BOOL_PARAM(BUS_LOG,SYS_PARAM),
+	{"", NULL, UINT, SYS_PARAM, false, false} // tracer value to signify end of list; if you delete it, epic fail will result
 };
 
 void IniReader::WriteParams(std::ofstream &visDataOut, paramType type)
@@ -464,8 +529,18 @@ bool IniReader::CheckIfAllSet()
 			{
 				//the string and bool values can be defaulted, but generally we need all the numeric values to be set to continue
 			case UINT:
-			case UINT64:
+				if (configMap[i].hasDefault)
+				{
+					DEBUG("\tSetting Default: "<<configMap[i].iniKey<<"="<<*((unsigned *)configMap[i].variablePtr));
+					break;
+				}
 			case FLOAT:
+				if (configMap[i].hasDefault)
+				{
+					DEBUG("\tSetting Default: "<<configMap[i].iniKey<<"="<<*((float *)configMap[i].variablePtr));
+					break;
+				}
+			case UINT64:
 				ERROR("Cannot continue without key '"<<configMap[i].iniKey<<"' set.");
 				return false;
 				break;
@@ -478,6 +553,16 @@ bool IniReader::CheckIfAllSet()
 			}
 		}
 	}
+#ifdef RELEASE_BUILD
+	for (size_t i=0; configMap[i].variablePtr != NULL; i++)
+	{
+		const string &key = configMap[i].iniKey;
+		if ((key.compare(0, 6, "DEBUG_") == 0 || key == "VERIFICATION_OUTPUT") && *((bool *)configMap[i].variablePtr))
+		{
+			cout << "WARNING: "<<key<<" has no effect in a release build" << endl;
+		}
+	}
+#endif
 	return true;
 }
 
@@ -640,6 +725,71 @@ void IniReader::InitEnumsFromStrings()
 		schedulingPolicy = BankThenRankRoundRobin;
 	}
 
+	// older ini files don't have this key, so an empty value means csv
+	if (VIS_FILE_FORMAT == "csv" || VIS_FILE_FORMAT == "")
+	{
+		visFileFormat = CSVVisFile;
+	}
+	else if (VIS_FILE_FORMAT == "binary")
+	{
+		visFileFormat = BinaryVisFile;
+		if (DEBUG_INI_READER) 
+		{
+			DEBUG("VIS FILE: binary");
+		}
+	}
+	else
+	{
+		cout << "WARNING: Unknown vis file format '"<<VIS_FILE_FORMAT<<"'; valid options are 'csv' or 'binary'; defaulting to csv" << endl;
+		visFileFormat = CSVVisFile;
+	}
+
+	if (COMMAND_TRACE == "none" || COMMAND_TRACE == "")
+	{
+		commandTraceFormat = NoCommandTrace;
+	}
+	else if (COMMAND_TRACE == "raw")
+	{
+		commandTraceFormat = RawCommandTrace;
+	}
+	else if (COMMAND_TRACE == "gzip")
+	{
+		commandTraceFormat = GzipCommandTrace;
+	}
+	else
+	{
+		cout << "WARNING: Unknown command trace format '"<<COMMAND_TRACE<<"'; valid options are 'none', 'raw' or 'gzip'; defaulting to none" << endl;
+		commandTraceFormat = NoCommandTrace;
+	}
+
+	if (POWER_MODEL == "legacy" || POWER_MODEL == "")
+	{
+		powerModelType = LegacyPower;
+	}
+	else if (POWER_MODEL == "detailed")
+	{
+		powerModelType = DetailedPower;
+	}
+	else
+	{
+		cout << "WARNING: Unknown power model '"<<POWER_MODEL<<"'; valid options are 'legacy' or 'detailed'; defaulting to legacy" << endl;
+		powerModelType = LegacyPower;
+	}
+
+	if (MEMORY_MODEL == "detailed" || MEMORY_MODEL == "")
+	{
+		memoryModelType = DetailedModel;
+	}
+	else if (MEMORY_MODEL == "fast")
+	{
+		memoryModelType = FastModel;
+	}
+	else
+	{
+		cout << "WARNING: Unknown memory model '"<<MEMORY_MODEL<<"'; valid options are 'detailed' or 'fast'; defaulting to detailed" << endl;
+		memoryModelType = DetailedModel;
+	}
+
 }
 
 } // namespace DRAMSim
@@ -40,11 +40,14 @@
 
 using namespace std;
 
-#define DEFINE_UINT_PARAM(name, paramtype) {#name, &name, UINT, paramtype, false}
-#define DEFINE_STRING_PARAM(name, paramtype) {#name, &name, STRING, paramtype, false}
-#define DEFINE_FLOAT_PARAM(name,paramtype) {#name, &name, FLOAT, paramtype, false}
-#define DEFINE_BOOL_PARAM(name, paramtype) {#name, &name, BOOL, paramtype, false}
-#define DEFINE_UINT64_PARAM(name, paramtype) {#name, &name, UINT64, paramtype, false}
+#define DEFINE_UINT_PARAM(name, paramtype) {#name, &name, UINT, paramtype, false, false}
+#define DEFINE_STRING_PARAM(name, paramtype) {#name, &name, STRING, paramtype, false, false}
+#define DEFINE_FLOAT_PARAM(name,paramtype) {#name, &name, FLOAT, paramtype, false, false}
+#define DEFINE_BOOL_PARAM(name, paramtype) {#name, &name, BOOL, paramtype, false, false}
+#define DEFINE_UINT64_PARAM(name, paramtype) {#name, &name, UINT64, paramtype, false, false}
+// numeric parameters that keep the value they are initialized with if they are missing from the ini file
+#define DEFINE_OPTIONAL_UINT_PARAM(name, paramtype) {#name, &name, UINT, paramtype, false, true}
+#define DEFINE_OPTIONAL_FLOAT_PARAM(name, paramtype) {#name, &name, FLOAT, paramtype, false, true}
 
 namespace DRAMSim
 {
@@ -59,6 +62,7 @@ typedef struct _configMap
 	varType variableType;
 	paramType parameterType;
 	bool wasSet;
+	bool hasDefault;
 } ConfigMap;
 
 class IniReader
@@ -0,0 +1,162 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+//LatencyHistogram.cpp
+//
+//Class file for the log-linear latency histogram
+//
+
+#include "LatencyHistogram.h"
+#include "SystemConfiguration.h"
+#include "Checkpoint.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+LatencyHistogram::LatencyHistogram(unsigned precisionBits_) :
+	precisionBits(precisionBits_),
+	subBinCount(1U << precisionBits_),
+	totalCount(0),
+	maxLatency(0)
+{
+	if (precisionBits < 1 || precisionBits > 12)
+	{
+		ERROR("== Error - The latency histogram precision must be between 1 and 12 bits, not "<<precisionBits);
+		exit(-1);
+	}
+	bins.resize((size_t)(33 - precisionBits) << precisionBits, 0);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+	if (other.precisionBits != precisionBits)
+	{
+		ERROR("== Error - Cannot merge latency histograms of different precisions");
+		abort();
+	}
+	for (size_t i=0; i<bins.size(); i++)
+	{
+		bins[i] += other.bins[i];
+	}
+	totalCount += other.totalCount;
+	if (other.maxLatency > maxLatency)
+	{
+		maxLatency = other.maxLatency;
+	}
+}
+
+void LatencyHistogram::reset()
+{
+	bins.assign(bins.size(), 0);
+	totalCount = 0;
+	maxLatency = 0;
+}
+
+uint64_t LatencyHistogram::count() const
+{
+	return totalCount;
+}
+
+uint64_t LatencyHistogram::max() const
+{
+	return maxLatency;
+}
+
+/*
+ * The latency below which pct percent of the samples fall. This is the upper
+ * bound of the bin the percentile lands in, so it is never an underestimate.
+ */
+uint64_t LatencyHistogram::percentile(double pct) const
+{
+	if (totalCount == 0)
+	{
+		return 0;
+	}
+	uint64_t target = (uint64_t)(pct / 100.0 * totalCount + 0.5);
+	if (target < 1)
+	{
+		target = 1;
+	}
+
+	uint64_t seen = 0;
+	for (size_t i=0; i<bins.size(); i++)
+	{
+		seen += bins[i];
+		if (seen >= target)
+		{
+			return binUpperBound(i) < maxLatency ? binUpperBound(i) : maxLatency;
+		}
+	}
+	return maxLatency;
+}
+
+size_t LatencyHistogram::numBins() const
+{
+	return bins.size();
+}
+
+uint64_t LatencyHistogram::binCount(size_t bin) const
+{
+	return bins[bin];
+}
+
+uint64_t LatencyHistogram::binLowerBound(size_t bin) const
+{
+	if (bin < subBinCount)
+	{
+		return bin;
+	}
+	unsigned shift = (bin >> precisionBits) - 1;
+	return (uint64_t)(subBinCount + (bin & (subBinCount - 1))) << shift;
+}
+
+uint64_t LatencyHistogram::binUpperBound(size_t bin) const
+{
+	if (bin < subBinCount)
+	{
+		return bin;
+	}
+	unsigned shift = (bin >> precisionBits) - 1;
+	return binLowerBound(bin) + (1ULL << shift) - 1;
+}
+
+void LatencyHistogram::checkpoint(Checkpoint &cp)
+{
+	cp.checkSize(bins.size());
+	for (size_t i=0; i<bins.size(); i++)
+	{
+		cp.io(bins[i]);
+	}
+	cp.io(totalCount);
+	cp.io(maxLatency);
+}
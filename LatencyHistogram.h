@@ -0,0 +1,115 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+//LatencyHistogram.h
+//
+//Header file for the log-linear latency histogram
+//
+
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+using std::vector;
+
+namespace DRAMSim
+{
+class Checkpoint;
+
+/*
+ * A log-linear (HDR style) histogram of latencies in cycles.
+ *
+ * With a precision of p bits, every latency below 2^p cycles gets a bin of
+ * its own. Above that, each power of two is split into 2^p equally wide bins,
+ * so a bin is never wider than 1/2^p of the values in it. Latencies of 2^32
+ * cycles or more are counted in the last bin. Inserting is a couple of shifts
+ * and an increment, and the memory used only depends on the precision
+ * ((33-p)*2^p counters).
+ */
+class LatencyHistogram
+{
+public:
+	LatencyHistogram(unsigned precisionBits_);
+
+	void insert(uint64_t latency)
+	{
+		if (latency > 0xFFFFFFFFULL)
+		{
+			latency = 0xFFFFFFFFULL;
+		}
+		bins[binIndex((uint32_t)latency)]++;
+		totalCount++;
+		if (latency > maxLatency)
+		{
+			maxLatency = latency;
+		}
+	}
+
+	void merge(const LatencyHistogram &other);
+	void reset();
+	void checkpoint(Checkpoint &cp);
+
+	uint64_t count() const;
+	uint64_t max() const;
+	uint64_t percentile(double pct) const;
+
+	// bins, for printing the whole histogram
+	size_t numBins() const;
+	uint64_t binCount(size_t bin) const;
+	uint64_t binLowerBound(size_t bin) const;
+	uint64_t binUpperBound(size_t bin) const;
+
+private:
+	size_t binIndex(uint32_t latency) const
+	{
+		if (latency < subBinCount)
+		{
+			return latency;
+		}
+		unsigned msb = 31 - __builtin_clz(latency);
+		unsigned shift = msb - precisionBits;
+		return ((size_t)(shift + 1) << precisionBits) + ((latency >> shift) - subBinCount);
+	}
+
+	unsigned precisionBits;
+	uint32_t subBinCount;
+	vector<uint64_t> bins;
+	uint64_t totalCount;
+	uint64_t maxLatency;
+};
+}
+
+#endif
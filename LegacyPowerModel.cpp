@@ -0,0 +1,87 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+//LegacyPowerModel.cpp
+//
+//Class file for the original DRAMSim2 power model
+//
+
+#include "LegacyPowerModel.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+LegacyPowerModel::LegacyPowerModel(unsigned numRanks_) :
+	PowerModel(numRanks_),
+	toEnergy(NUM_DEVICES * Vdd * tCK)
+{
+}
+
+void LegacyPowerModel::command(unsigned rank, BusPacketType type)
+{
+	switch (type)
+	{
+	case READ:
+	case READ_P:
+		energy[rank].burst += (IDD4R - IDD3N) * BL/2 * toEnergy;
+		break;
+	case WRITE:
+	case WRITE_P:
+		energy[rank].burst += (IDD4W - IDD3N) * BL/2 * toEnergy;
+		break;
+	case ACTIVATE:
+		energy[rank].actpre += ((IDD0 * tRC) - ((IDD3N * tRAS) + (IDD2N * (tRC - tRAS)))) * toEnergy;
+		break;
+	case REFRESH:
+		energy[rank].refresh += (IDD5 - IDD3N) * tRFC * toEnergy;
+		break;
+	default:
+		break;
+	}
+}
+
+double LegacyPowerModel::backgroundEnergy(RankState state, unsigned openBanks) const
+{
+	switch (state)
+	{
+	case ActiveStandby:
+	case ActivePowerDown:
+		return IDD3N * toEnergy;
+	case PrechargePowerDown:
+		return IDD2P * toEnergy;
+	case SelfRefresh:
+		return IDD6 * toEnergy;
+	default:
+		return IDD2N * toEnergy;
+	}
+}
@@ -0,0 +1,69 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+#ifndef LEGACYPOWERMODEL_H
+#define LEGACYPOWERMODEL_H
+
+//LegacyPowerModel.h
+//
+//Header file for the original DRAMSim2 power model
+//
+
+#include "PowerModel.h"
+
+namespace DRAMSim
+{
+/*
+ * The power model DRAMSim2 has always used (POWER_MODEL=legacy, the
+ * default): IDD3N while any bank of the rank is open, else IDD2P in power
+ * down and IDD2N otherwise, plus the energy of a whole activate/precharge
+ * cycle at every ACT, of a burst at every read or write and of tRFC at
+ * every refresh, each above the IDD3N background.
+ */
+class LegacyPowerModel : public PowerModel
+{
+public:
+	LegacyPowerModel(unsigned numRanks_);
+
+	virtual void command(unsigned rank, BusPacketType type);
+
+protected:
+	virtual double backgroundEnergy(RankState state, unsigned openBanks) const;
+
+private:
+	double toEnergy; // pJ per mA*cycle of all devices
+};
+}
+
+#endif
+
@@ -0,0 +1,151 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+//LiveStats.cpp
+//
+//Class file for the shared memory live statistics publisher
+//
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#include "LiveStats.h"
+#include "PrintMacros.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+static double wallTime()
+{
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return now.tv_sec + now.tv_usec * 1E-6;
+}
+
+LiveStatsPublisher::LiveStatsPublisher(const string &name_, unsigned numChannels_, unsigned capacity_) :
+	name(name_),
+	numChannels(numChannels_),
+	capacity(capacity_),
+	segmentSize(sizeof(LiveStatsHeader) + capacity_ * recordSize(numChannels_)),
+	header(NULL),
+	channels(numChannels_),
+	lastCycle(0),
+	lastWallTime(wallTime())
+{
+	int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+	if (fd < 0)
+	{
+		ERROR("Cannot open shared memory segment '"<<name<<"': "<<strerror(errno));
+		exit(-1);
+	}
+	if (ftruncate(fd, segmentSize) != 0)
+	{
+		ERROR("Cannot resize shared memory segment '"<<name<<"': "<<strerror(errno));
+		exit(-1);
+	}
+	void *segment = mmap(NULL, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (segment == MAP_FAILED)
+	{
+		ERROR("Cannot map shared memory segment '"<<name<<"': "<<strerror(errno));
+		exit(-1);
+	}
+	memset(segment, 0, segmentSize);
+
+	header = (LiveStatsHeader *)segment;
+	header->version = 1;
+	header->numChannels = numChannels;
+	header->capacity = capacity;
+	header->recordSize = recordSize(numChannels);
+	header->writeIndex = 0;
+	// readers check the magic last, so it only shows up once the rest is valid
+	__sync_synchronize();
+	memcpy(header->magic, "DRAMLIVE", sizeof(header->magic));
+}
+
+LiveStatsPublisher::~LiveStatsPublisher()
+{
+	munmap(header, segmentSize);
+	shm_unlink(name.c_str());
+}
+
+size_t LiveStatsPublisher::recordSize(unsigned numChannels)
+{
+	size_t size = offsetof(LiveStatsRecord, channels) + numChannels * sizeof(LiveStatsChannel);
+	// keep every record 8 byte aligned
+	return (size + 7) & ~(size_t)7;
+}
+
+LiveStatsRecord *LiveStatsPublisher::slot(uint64_t index)
+{
+	char *records = (char *)header + sizeof(LiveStatsHeader);
+	return (LiveStatsRecord *)(records + (index % capacity) * recordSize(numChannels));
+}
+
+void LiveStatsPublisher::setChannel(unsigned channel, const LiveStatsChannel &stats)
+{
+	channels[channel] = stats;
+}
+
+/*
+ * Writes the channels set since the last call as the next record. The
+ * sequence number is made odd before and even after the copy, with full
+ * barriers in between, so a reader that sees the same even sequence before
+ * and after its own copy knows it wasn't torn.
+ */
+void LiveStatsPublisher::publish(uint64_t cycle, double simulatedMs)
+{
+	double now = wallTime();
+	double elapsed = now - lastWallTime;
+
+	uint64_t index = header->writeIndex;
+	LiveStatsRecord *record = slot(index);
+	record->sequence = 2*index + 1;
+	__sync_synchronize();
+	record->cycle = cycle;
+	record->simulatedMs = simulatedMs;
+	record->cyclesPerSecond = elapsed > 0.0 ? (cycle - lastCycle) / elapsed : 0.0;
+	memcpy(record->channels, &channels[0], numChannels * sizeof(LiveStatsChannel));
+	__sync_synchronize();
+	record->sequence = 2*index + 2;
+	header->writeIndex = index + 1;
+
+	lastCycle = cycle;
+	lastWallTime = now;
+}
@@ -0,0 +1,126 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+#ifndef LIVESTATS_H
+#define LIVESTATS_H
+
+//LiveStats.h
+//
+//Header file for the shared memory live statistics publisher
+//
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+using std::string;
+using std::vector;
+
+namespace DRAMSim
+{
+/*
+ * The epoch statistics can be published to a POSIX shared memory segment
+ * (LIVE_STATS_SHM in system.ini, e.g. /dramsim) so that an external process
+ * can watch a long simulation while it runs. The segment is laid out as
+ *
+ *   LiveStatsHeader
+ *   capacity records of recordSize bytes each (LiveStatsRecord followed by
+ *   numChannels LiveStatsChannel entries)
+ *
+ * and record n is written to slot n % capacity. The simulator never waits
+ * for a reader: each record is protected by a sequence number that is odd
+ * while the record is being written and 2*(n+1) once record n is complete.
+ * To read the latest record, a reader loads writeIndex (the number of
+ * records published), reads the sequence of slot (writeIndex-1) % capacity,
+ * copies the record, reads the sequence again and retries if the two differ
+ * or aren't 2*writeIndex. Everything is in host byte order.
+ */
+struct LiveStatsHeader
+{
+	char magic[8]; // "DRAMLIVE"
+	uint32_t version;
+	uint32_t numChannels;
+	uint32_t capacity;
+	uint32_t recordSize;
+	volatile uint64_t writeIndex;
+};
+
+struct LiveStatsChannel
+{
+	double bandwidth; // GB/s
+	double latencyP50; // read latency percentiles in ns
+	double latencyP90;
+	double latencyP99;
+	double latencyMax;
+	uint64_t reads;
+	uint64_t writes;
+	uint32_t transactionQueueSize; // occupancy at the end of the epoch
+	uint32_t pendingReads;
+};
+
+struct LiveStatsRecord
+{
+	volatile uint64_t sequence;
+	uint64_t cycle;
+	double simulatedMs;
+	double cyclesPerSecond; // simulation speed since the previous record
+	LiveStatsChannel channels[1]; // numChannels entries
+};
+
+class LiveStatsPublisher
+{
+public:
+	LiveStatsPublisher(const string &name_, unsigned numChannels_, unsigned capacity_=64);
+	~LiveStatsPublisher();
+
+	void setChannel(unsigned channel, const LiveStatsChannel &stats);
+	void publish(uint64_t cycle, double simulatedMs);
+
+	static size_t recordSize(unsigned numChannels);
+
+private:
+	LiveStatsRecord *slot(uint64_t index);
+
+	string name;
+	unsigned numChannels;
+	unsigned capacity;
+	size_t segmentSize;
+	LiveStatsHeader *header;
+	vector<LiveStatsChannel> channels; // filled in by setChannel() until the next publish()
+	uint64_t lastCycle;
+	double lastWallTime;
+};
+}
+
+#endif
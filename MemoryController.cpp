@@ -38,39 +38,80 @@
 #include "MemoryController.h"
 #include "MemorySystem.h"
 #include "AddressMapping.h"
+#include "SimProfiler.h"
+#include "Checkpoint.h"
 
 #define SEQUENTIAL(rank,bank) (rank*NUM_BANKS)+bank
 
-/* Power computations are localized to MemoryController.cpp */ 
-extern unsigned IDD0;
-extern unsigned IDD1;
-extern unsigned IDD2P;
-extern unsigned IDD2Q;
-extern unsigned IDD2N;
-extern unsigned IDD3Pf;
-extern unsigned IDD3Ps;
-extern unsigned IDD3N;
-extern unsigned IDD4W;
-extern unsigned IDD4R;
-extern unsigned IDD5;
-extern unsigned IDD6;
-extern unsigned IDD6L;
-extern unsigned IDD7;
-extern float Vdd; 
-
 using namespace DRAMSim;
 
-MemoryController::MemoryController(MemorySystem *parent, CSVWriter &csvOut_, ostream &dramsim_log_) :
+// read latency percentiles reported every epoch (100 is the maximum)
+static const double latencyPercentiles[] = {50.0, 90.0, 99.0, 99.9, 100.0};
+static const char *latencyPercentileNames[] = {"p50", "p90", "p99", "p99.9", "Max"};
+#define NUM_LATENCY_PERCENTILES (sizeof(latencyPercentiles)/sizeof(latencyPercentiles[0]))
+
+// components of a read's latency with LATENCY_BREAKDOWN; they add up to the
+// end-to-end latency
+enum LatencyComponent
+{
+	TransactionQueueLatency, // admission until broken into commands
+	CommandQueueLatency,     // waiting for the first command to be scheduled
+	RefreshLatency,          // part of that wait spent on a refresh of the rank
+	PrechargeLatency,        // part of that wait spent closing another row (bank conflict)
+	ActivateLatency,         // ACT until CAS (0 for row buffer hits)
+	DataLatency,             // CAS until the data is returned
+	NUM_LATENCY_COMPONENTS
+};
+static const char *latencyComponentNames[] = {"TransQueue", "CmdQueue", "Refresh", "Precharge", "Activate", "Data"};
+
+// command counts reported every epoch; the auto-precharge variants are
+// counted with READ and WRITE
+enum CommandCount
+{
+	ActivateCount,
+	PrechargeCount,
+	ReadCount,
+	WriteCount,
+	RefreshCount,
+	NUM_COMMAND_COUNTS
+};
+static const char *commandCountNames[] = {"ACT", "PRE", "RD", "WR", "REF"};
+
+static bool isWriteCommand(BusPacketType type)
+{
+	return type == WRITE || type == WRITE_P;
+}
+
+MemoryController::MemoryController(MemorySystem *parent, StatsWriter &statsOut_, ostream &dramsim_log_) :
 		dramsim_log(dramsim_log_),
 		bankStates(NUM_RANKS, vector<BankState>(NUM_BANKS, dramsim_log)),
 		commandQueue(bankStates, dramsim_log_),
 		poppedBusPacket(NULL),
-		csvOut(csvOut_),
+		latencies(HISTOGRAM_PRECISION),
+		epochLatencies(HISTOGRAM_PRECISION),
+		statsOut(statsOut_),
 		totalTransactions(0),
 		refreshRank(0)
 {
+	//row buffer and bus statistics
+	rowHits = vector<uint64_t>(NUM_RANKS*NUM_BANKS,0);
+	rowMisses = vector<uint64_t>(NUM_RANKS*NUM_BANKS,0);
+	rowConflicts = vector<uint64_t>(NUM_RANKS*NUM_BANKS,0);
+	bankBusyCycles = vector<uint64_t>(NUM_RANKS*NUM_BANKS,0);
+	activatePending = vector<bool>(NUM_RANKS*NUM_BANKS,false);
+	conflictPending = vector<bool>(NUM_RANKS*NUM_BANKS,false);
+	commandCounts = vector<uint64_t>(DATA+1,0);
+	readToWriteTurnarounds = 0;
+	writeToReadTurnarounds = 0;
+	lastColumnCommand = DATA;
+	epochSummary = LiveStatsChannel();
+
 	//get handle on parent
 	parentMemorySystem = parent;
+	busLog = NULL;
+	commandTrace = NULL;
+	completedTransactions = 0;
+	completionQueue = NULL;
 
 
 	//bus related fields
@@ -100,14 +141,88 @@ MemoryController::MemoryController(MemorySystem *parent, CSVWriter &csvOut_, ost
 	burstEnergy = vector <uint64_t> (NUM_RANKS,0);
 	actpreEnergy = vector <uint64_t> (NUM_RANKS,0);
 	refreshEnergy = vector <uint64_t> (NUM_RANKS,0);
+	powerModel = PowerModel::create(NUM_RANKS);
+	openBanks = vector<unsigned>(NUM_RANKS,0);
+	rankPowerState = vector<PowerModel::RankState>(NUM_RANKS,PowerModel::PrechargeStandby);
 
 	totalEpochLatency = vector<uint64_t> (NUM_RANKS*NUM_BANKS,0);
+	if (PER_BANK_LATENCY_HISTOGRAMS)
+	{
+		bankLatencies = vector<LatencyHistogram>(NUM_RANKS*NUM_BANKS, LatencyHistogram(HISTOGRAM_PRECISION));
+	}
+	if (LATENCY_BREAKDOWN)
+	{
+		breakdownLatencies = vector<LatencyHistogram>(NUM_LATENCY_COMPONENTS, LatencyHistogram(HISTOGRAM_PRECISION));
+		totalBreakdownLatency = vector<uint64_t>(NUM_LATENCY_COMPONENTS,0);
+		refreshRequestCycle = vector<uint64_t>(NUM_RANKS,0);
+		refreshEndCycle = vector<uint64_t>(NUM_RANKS,0);
+		lastPrechargeCycle = vector<uint64_t>(NUM_RANKS*NUM_BANKS,0);
+	}
 
 	//staggers when each rank is due for a refresh
 	for (size_t i=0;i<NUM_RANKS;i++)
 	{
 		refreshCountdown.push_back((int)((REFRESH_PERIOD/tCK)/NUM_RANKS)*(i+1));
 	}
+
+	//register the vis file columns in the order printStats() has always written them
+	unsigned myChannel = parentMemorySystem->systemID;
+	for (size_t r=0;r<NUM_RANKS;r++)
+	{
+		backgroundPowerColumn.push_back(statsOut.addColumn(StatsWriter::indexedName("Background_Power",myChannel,r)));
+		actprePowerColumn.push_back(statsOut.addColumn(StatsWriter::indexedName("ACT_PRE_Power",myChannel,r)));
+		burstPowerColumn.push_back(statsOut.addColumn(StatsWriter::indexedName("Burst_Power",myChannel,r)));
+		refreshPowerColumn.push_back(statsOut.addColumn(StatsWriter::indexedName("Refresh_Power",myChannel,r)));
+		for (size_t b=0; b<NUM_BANKS; b++)
+		{
+			bandwidthColumn.push_back(statsOut.addColumn(StatsWriter::indexedName("Bandwidth",myChannel,r,b)));
+			averageLatencyColumn.push_back(statsOut.addColumn(StatsWriter::indexedName("Average_Latency",myChannel,r,b)));
+		}
+		rankAggregateBandwidthColumn.push_back(statsOut.addColumn(StatsWriter::indexedName("Rank_Aggregate_Bandwidth",myChannel,r)));
+		rankAverageBandwidthColumn.push_back(statsOut.addColumn(StatsWriter::indexedName("Rank_Average_Bandwidth",myChannel,r)));
+	}
+	aggregateBandwidthColumn = statsOut.addColumn(StatsWriter::indexedName("Aggregate_Bandwidth",myChannel));
+	averageBandwidthColumn = statsOut.addColumn(StatsWriter::indexedName("Average_Bandwidth",myChannel));
+	for (size_t i=0; i<NUM_LATENCY_PERCENTILES; i++)
+	{
+		latencyPercentileColumn.push_back(statsOut.addColumn(StatsWriter::indexedName((string("Latency_")+latencyPercentileNames[i]).c_str(),myChannel)));
+	}
+	if (LATENCY_BREAKDOWN)
+	{
+		for (size_t i=0; i<NUM_LATENCY_COMPONENTS; i++)
+		{
+			string name = string("Latency_")+latencyComponentNames[i];
+			breakdownMeanColumn.push_back(statsOut.addColumn(StatsWriter::indexedName((name+"_Mean").c_str(),myChannel)));
+			breakdownP99Column.push_back(statsOut.addColumn(StatsWriter::indexedName((name+"_p99").c_str(),myChannel)));
+		}
+	}
+	for (size_t r=0;r<NUM_RANKS;r++)
+	{
+		for (size_t b=0; b<NUM_BANKS; b++)
+		{
+			rowHitsColumn.push_back(statsOut.addColumn(StatsWriter::indexedName("Row_Hits",myChannel,r,b)));
+			rowMissesColumn.push_back(statsOut.addColumn(StatsWriter::indexedName("Row_Misses",myChannel,r,b)));
+			rowConflictsColumn.push_back(statsOut.addColumn(StatsWriter::indexedName("Row_Conflicts",myChannel,r,b)));
+			bankUtilizationColumn.push_back(statsOut.addColumn(StatsWriter::indexedName("Bank_Utilization",myChannel,r,b)));
+		}
+	}
+	commandBusUtilizationColumn = statsOut.addColumn(StatsWriter::indexedName("Command_Bus_Utilization",myChannel));
+	dataBusUtilizationColumn = statsOut.addColumn(StatsWriter::indexedName("Data_Bus_Utilization",myChannel));
+	readToWriteColumn = statsOut.addColumn(StatsWriter::indexedName("Read_To_Write_Turnarounds",myChannel));
+	writeToReadColumn = statsOut.addColumn(StatsWriter::indexedName("Write_To_Read_Turnarounds",myChannel));
+	for (size_t i=0; i<NUM_COMMAND_COUNTS; i++)
+	{
+		commandCountColumn.push_back(statsOut.addColumn(StatsWriter::indexedName((string(commandCountNames[i])+"_Commands").c_str(),myChannel)));
+	}
+	energyPerBitColumn = statsOut.addColumn(StatsWriter::indexedName("Energy_Per_Bit",myChannel));
+	for (size_t r=0;r<NUM_RANKS;r++)
+	{
+		for (size_t i=0; i<PowerModel::NUM_RANK_STATES; i++)
+		{
+			string name = string("Residency_")+PowerModel::rankStateNames[i];
+			residencyColumn.push_back(statsOut.addColumn(StatsWriter::indexedName(name.c_str(),myChannel,r)));
+		}
+	}
 }
 
 //get a bus packet from either data or cmd bus
@@ -125,6 +240,10 @@ void MemoryController::receiveFromBus(BusPacket *bpacket)
 		PRINTN(" -- MC Receiving From Data Bus : ");
 		bpacket->print();
 	}
+	if (busLog != NULL)
+	{
+		busLog->record(BusLog::MCDataReceive, parentMemorySystem->systemID, currentClockCycle, bpacket);
+	}
 
 	//add to return read data queue
 	returnTransaction.push_back(new Transaction(RETURN_DATA, bpacket->physicalAddress, bpacket->data));
@@ -137,6 +256,12 @@ void MemoryController::receiveFromBus(BusPacket *bpacket)
 //sends read data back to the CPU
 void MemoryController::returnReadData(const Transaction *trans)
 {
+	completedTransactions++;
+	if (completionQueue != NULL)
+	{
+		Completion completion = {trans->address, currentClockCycle, currentClockCycle - trans->timeAdded, trans->tag, parentMemorySystem->systemID, false};
+		completionQueue->push(completion);
+	}
 	if (parentMemorySystem->ReturnReadData!=NULL)
 	{
 		(*parentMemorySystem->ReturnReadData)(parentMemorySystem->systemID, trans->address, currentClockCycle);
@@ -152,6 +277,7 @@ void MemoryController::attachRanks(vector<Rank *> *ranks)
 //memory controller update
 void MemoryController::update()
 {
+	PROFILE_SCOPE(ControllerUpdate)
 
 	//PRINT(" ------------------------- [" << currentClockCycle << "] -------------------------");
 
@@ -160,6 +286,10 @@ void MemoryController::update()
 	{
 		for (size_t j=0;j<NUM_BANKS;j++)
 		{
+			if (bankStates[i][j].currentBankState != Idle && bankStates[i][j].currentBankState != PowerDown)
+			{
+				bankBusyCycles[SEQUENTIAL(i,j)]++;
+			}
 			if (bankStates[i][j].stateChangeCountdown>0)
 			{
 				//decrement counters
@@ -173,14 +303,14 @@ void MemoryController::update()
 						//only these commands have an implicit state change
 					case WRITE_P:
 					case READ_P:
-						bankStates[i][j].currentBankState = Precharging;
+						setBankState(i, j, Precharging);
 						bankStates[i][j].lastCommand = PRECHARGE;
 						bankStates[i][j].stateChangeCountdown = tRP;
 						break;
 
 					case REFRESH:
 					case PRECHARGE:
-						bankStates[i][j].currentBankState = Idle;
+						setBankState(i, j, Idle);
 						break;
 					default:
 						break;
@@ -209,6 +339,12 @@ void MemoryController::update()
 		if (dataCyclesLeft == 0)
 		{
 			//inform upper levels that a write is done
+			completedTransactions++;
+			if (completionQueue != NULL)
+			{
+				Completion completion = {outgoingDataPacket->physicalAddress, currentClockCycle, currentClockCycle - outgoingDataPacket->timeAdded, outgoingDataPacket->tag, parentMemorySystem->systemID, true};
+				completionQueue->push(completion);
+			}
 			if (parentMemorySystem->WriteDataDone!=NULL)
 			{
 				(*parentMemorySystem->WriteDataDone)(parentMemorySystem->systemID,outgoingDataPacket->physicalAddress, currentClockCycle);
@@ -240,6 +376,10 @@ void MemoryController::update()
 				PRINTN(" -- MC Issuing On Data Bus    : ");
 				writeDataToSend[0]->print();
 			}
+			if (busLog != NULL)
+			{
+				busLog->record(BusLog::MCDataIssue, parentMemorySystem->systemID, currentClockCycle, writeDataToSend[0]);
+			}
 
 			// queue up the packet to be sent
 			if (outgoingDataPacket != NULL)
@@ -265,6 +405,10 @@ void MemoryController::update()
 	{
 		commandQueue.needRefresh(refreshRank);
 		(*ranks)[refreshRank]->refreshWaiting = true;
+		if (LATENCY_BREAKDOWN)
+		{
+			refreshRequestCycle[refreshRank] = currentClockCycle;
+		}
 		refreshCountdown[refreshRank] =	 REFRESH_PERIOD/tCK;
 		refreshRank++;
 		if (refreshRank == NUM_RANKS)
@@ -289,6 +433,8 @@ void MemoryController::update()
 			writeDataToSend.push_back(new BusPacket(DATA, poppedBusPacket->physicalAddress, poppedBusPacket->column,
 			                                    poppedBusPacket->row, poppedBusPacket->rank, poppedBusPacket->bank,
 			                                    poppedBusPacket->data, dramsim_log));
+			writeDataToSend.back()->timeAdded = poppedBusPacket->timeAdded;
+			writeDataToSend.back()->tag = poppedBusPacket->tag;
 			writeDataCountdown.push_back(WL);
 		}
 
@@ -298,6 +444,11 @@ void MemoryController::update()
 		//for readability's sake
 		unsigned rank = poppedBusPacket->rank;
 		unsigned bank = poppedBusPacket->bank;
+		updateRowBufferStats(poppedBusPacket);
+		if (LATENCY_BREAKDOWN)
+		{
+			recordCommandIssue(poppedBusPacket);
+		}
 		switch (poppedBusPacket->busPacketType)
 		{
 			case READ_P:
@@ -307,7 +458,7 @@ void MemoryController::update()
 				{
 					PRINT(" ++ Adding Read energy to total energy");
 				}
-				burstEnergy[rank] += (IDD4R - IDD3N) * BL/2 * NUM_DEVICES;
+				powerModel->command(rank, poppedBusPacket->busPacketType);
 				if (poppedBusPacket->busPacketType == READ_P) 
 				{
 					//Don't bother setting next read or write times because the bank is no longer active
@@ -380,7 +531,7 @@ void MemoryController::update()
 				{
 					PRINT(" ++ Adding Write energy to total energy");
 				}
-				burstEnergy[rank] += (IDD4W - IDD3N) * BL/2 * NUM_DEVICES;
+				powerModel->command(rank, poppedBusPacket->busPacketType);
 
 				for (size_t i=0;i<NUM_RANKS;i++)
 				{
@@ -420,9 +571,9 @@ void MemoryController::update()
 				{
 					PRINT(" ++ Adding Activate and Precharge energy to total energy");
 				}
-				actpreEnergy[rank] += ((IDD0 * tRC) - ((IDD3N * tRAS) + (IDD2N * (tRC - tRAS)))) * NUM_DEVICES;
+				powerModel->command(rank, poppedBusPacket->busPacketType);
 
-				bankStates[rank][bank].currentBankState = RowActive;
+				setBankState(rank, bank, RowActive);
 				bankStates[rank][bank].lastCommand = ACTIVATE;
 				bankStates[rank][bank].openRowAddress = poppedBusPacket->row;
 				bankStates[rank][bank].nextActivate = max(currentClockCycle + tRC, bankStates[rank][bank].nextActivate);
@@ -443,7 +594,8 @@ void MemoryController::update()
 
 				break;
 			case PRECHARGE:
-				bankStates[rank][bank].currentBankState = Precharging;
+				powerModel->command(rank, poppedBusPacket->busPacketType);
+				setBankState(rank, bank, Precharging);
 				bankStates[rank][bank].lastCommand = PRECHARGE;
 				bankStates[rank][bank].stateChangeCountdown = tRP;
 				bankStates[rank][bank].nextActivate = max(currentClockCycle + tRP, bankStates[rank][bank].nextActivate);
@@ -455,12 +607,12 @@ void MemoryController::update()
 				{
 					PRINT(" ++ Adding Refresh energy to total energy");
 				}
-				refreshEnergy[rank] += (IDD5 - IDD3N) * tRFC * NUM_DEVICES;
+				powerModel->command(rank, poppedBusPacket->busPacketType);
 
 				for (size_t i=0;i<NUM_BANKS;i++)
 				{
 					bankStates[rank][i].nextActivate = currentClockCycle + tRFC;
-					bankStates[rank][i].currentBankState = Refreshing;
+					setBankState(rank, i, Refreshing);
 					bankStates[rank][i].lastCommand = REFRESH;
 					bankStates[rank][i].stateChangeCountdown = tRFC;
 				}
@@ -477,6 +629,14 @@ void MemoryController::update()
 			PRINTN(" -- MC Issuing On Command Bus : ");
 			poppedBusPacket->print();
 		}
+		if (busLog != NULL)
+		{
+			busLog->record(BusLog::MCCommandIssue, parentMemorySystem->systemID, currentClockCycle, poppedBusPacket);
+		}
+		if (commandTrace != NULL)
+		{
+			commandTrace->record(currentClockCycle, poppedBusPacket);
+		}
 
 		//check for collision on bus
 		if (outgoingCmdPacket != NULL)
@@ -497,11 +657,11 @@ void MemoryController::update()
 		//	will eventually add policies here
 		Transaction *transaction = transactionQueue[i];
 
-		//map address to rank,bank,row,col
-		unsigned newTransactionChan, newTransactionRank, newTransactionBank, newTransactionRow, newTransactionColumn;
-
-		// pass these in as references so they get set by the addressMapping function
-		addressMapping(transaction->address, newTransactionChan, newTransactionRank, newTransactionBank, newTransactionRow, newTransactionColumn);
+		//rank,bank,row,col were decoded when the transaction was added
+		unsigned newTransactionRank = transaction->rank;
+		unsigned newTransactionBank = transaction->bank;
+		unsigned newTransactionRow = transaction->row;
+		unsigned newTransactionColumn = transaction->column;
 
 		//if we have room, break up the transaction into the appropriate commands
 		//and add them to the command queue
@@ -539,9 +699,18 @@ void MemoryController::update()
 			BusPacket *command = new BusPacket(bpType, transaction->address,
 					newTransactionColumn, newTransactionRow, newTransactionRank,
 					newTransactionBank, transaction->data, dramsim_log);
+			command->timeAdded = transaction->timeAdded;
+			command->tag = transaction->tag;
 
 
 
+			if (LATENCY_BREAKDOWN && transaction->transactionType == DATA_READ)
+			{
+				transaction->timeCommandQueued = currentClockCycle;
+				ACTcommand->transaction = transaction;
+				command->transaction = transaction;
+			}
+
 			commandQueue.enqueue(ACTcommand);
 			commandQueue.enqueue(command);
 
@@ -570,8 +739,8 @@ void MemoryController::update()
 	}
 
 
-	//calculate power
-	//  this is done on a per-rank basis, since power characterization is done per device (not per bank)
+	//power down idle ranks (the power model only hears about state changes,
+	//see setBankState() and updateRankPowerState())
 	for (size_t i=0;i<NUM_RANKS;i++)
 	{
 		if (USE_LOW_POWER)
@@ -597,9 +766,10 @@ void MemoryController::update()
 					(*ranks)[i]->powerDown();
 					for (size_t j=0;j<NUM_BANKS;j++)
 					{
-						bankStates[i][j].currentBankState = PowerDown;
+						setBankState(i, j, PowerDown);
 						bankStates[i][j].nextPowerUp = currentClockCycle + tCKE;
 					}
+					updateRankPowerState(i);
 				}
 			}
 			//if there IS something in the queue or there IS a refresh waiting (and we can power up), do it
@@ -609,51 +779,10 @@ void MemoryController::update()
 				(*ranks)[i]->powerUp();
 				for (size_t j=0;j<NUM_BANKS;j++)
 				{
-					bankStates[i][j].currentBankState = Idle;
+					setBankState(i, j, Idle);
 					bankStates[i][j].nextActivate = currentClockCycle + tXP;
 				}
-			}
-		}
-
-		//check for open bank
-		bool bankOpen = false;
-		for (size_t j=0;j<NUM_BANKS;j++)
-		{
-			if (bankStates[i][j].currentBankState == Refreshing ||
-			        bankStates[i][j].currentBankState == RowActive)
-			{
-				bankOpen = true;
-				break;
-			}
-		}
-
-		//background power is dependent on whether or not a bank is open or not
-		if (bankOpen)
-		{
-			if (DEBUG_POWER)
-			{
-				PRINT(" ++ Adding IDD3N to total energy [from rank "<< i <<"]");
-			}
-			backgroundEnergy[i] += IDD3N * NUM_DEVICES;
-		}
-		else
-		{
-			//if we're in power-down mode, use the correct current
-			if (powerDown[i])
-			{
-				if (DEBUG_POWER)
-				{
-					PRINT(" ++ Adding IDD2P to total energy [from rank " << i << "]");
-				}
-				backgroundEnergy[i] += IDD2P * NUM_DEVICES;
-			}
-			else
-			{
-				if (DEBUG_POWER)
-				{
-					PRINT(" ++ Adding IDD2N to total energy [from rank " << i << "]");
-				}
-				backgroundEnergy[i] += IDD2N * NUM_DEVICES;
+				updateRankPowerState(i);
 			}
 		}
 	}
@@ -678,9 +807,11 @@ void MemoryController::update()
 				//		pendingReadTransactions[i]->print();
 				//		exit(0);
 				//	}
-				unsigned chan,rank,bank,row,col;
-				addressMapping(returnTransaction[0]->address,chan,rank,bank,row,col);
-				insertHistogram(currentClockCycle-pendingReadTransactions[i]->timeAdded,rank,bank);
+				insertHistogram(currentClockCycle-pendingReadTransactions[i]->timeAdded,pendingReadTransactions[i]->rank,pendingReadTransactions[i]->bank);
+				if (LATENCY_BREAKDOWN)
+				{
+					insertLatencyBreakdown(pendingReadTransactions[i]);
+				}
 				//return latency
 				returnReadData(pendingReadTransactions[i]);
 
@@ -770,7 +901,9 @@ bool MemoryController::addTransaction(Transaction *trans)
 	if (WillAcceptTransaction())
 	{
 		trans->timeAdded = currentClockCycle;
+		trans->mapAddress();
 		transactionQueue.push_back(trans);
+		PROFILE_COUNT_TRANSACTION()
 		return true;
 	}
 	else 
@@ -779,6 +912,111 @@ bool MemoryController::addTransaction(Transaction *trans)
 	}
 }
 
+//true if there are no requests anywhere between the transaction queue and the ranks
+bool MemoryController::isIdle()
+{
+	if (!transactionQueue.empty() || !pendingReadTransactions.empty() || !returnTransaction.empty() ||
+	        !writeDataToSend.empty() || outgoingCmdPacket != NULL || outgoingDataPacket != NULL)
+	{
+		return false;
+	}
+	for (size_t i=0;i<NUM_RANKS;i++)
+	{
+		if (!commandQueue.isEmpty(i) || (*ranks)[i]->refreshWaiting || !(*ranks)[i]->isIdle())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * Skip ahead without simulating the cycles in between. The only state that is
+ * carried along is which rows are open and the refresh schedule: every refresh
+ * that falls into the skipped cycles closes the banks of its rank. Statistics
+ * are not updated and power-down is not modeled, so this is only good enough
+ * for getting through the unmeasured parts of a sampled simulation. The
+ * controller has to be idle.
+ */
+void MemoryController::fastForward(uint64_t cycles)
+{
+	if (!isIdle())
+	{
+		ERROR("== Error - Trying to fast forward while requests are in flight");
+		abort();
+	}
+
+	uint64_t remaining = cycles;
+	while (remaining > 0)
+	{
+		//the cycles until the next refresh are uneventful
+		uint64_t skip = min(remaining, (uint64_t)refreshCountdown[refreshRank]);
+		for (size_t i=0;i<NUM_RANKS;i++)
+		{
+			refreshCountdown[i] -= skip;
+		}
+		remaining -= skip;
+		if (remaining == 0)
+		{
+			break;
+		}
+
+		//the same as update(): refresh this rank, then count down
+		for (size_t j=0;j<NUM_BANKS;j++)
+		{
+			setBankState(refreshRank, j, Idle);
+			(*ranks)[refreshRank]->bankStates[j].currentBankState = Idle;
+		}
+		refreshCountdown[refreshRank] = REFRESH_PERIOD/tCK;
+		refreshRank++;
+		if (refreshRank == NUM_RANKS)
+		{
+			refreshRank = 0;
+		}
+		for (size_t i=0;i<NUM_RANKS;i++)
+		{
+			refreshCountdown[i]--;
+		}
+		remaining--;
+	}
+
+	powerModel->skip(currentClockCycle, cycles);
+	currentClockCycle += cycles;
+	commandQueue.fastForward(cycles);
+	for (size_t i=0;i<NUM_RANKS;i++)
+	{
+		powerDown[i] = false;
+		for (size_t j=0;j<NUM_BANKS;j++)
+		{
+			if (bankStates[i][j].currentBankState != RowActive)
+			{
+				setBankState(i, j, Idle);
+			}
+			bankStates[i][j].stateChangeCountdown = 0;
+			bankStates[i][j].nextRead = currentClockCycle;
+			bankStates[i][j].nextWrite = currentClockCycle;
+			bankStates[i][j].nextActivate = currentClockCycle;
+			bankStates[i][j].nextPrecharge = currentClockCycle;
+			bankStates[i][j].nextPowerUp = currentClockCycle;
+		}
+		updateRankPowerState(i);
+	}
+}
+
+//the row buffer effect of an access during fast forward: open page leaves the row open
+void MemoryController::functionalAccess(uint64_t address)
+{
+	unsigned chan, rank, bank, row, col;
+	addressMapping(address, chan, rank, bank, row, col);
+	if (rowBufferPolicy == OpenPage)
+	{
+		setBankState(rank, bank, RowActive);
+		bankStates[rank][bank].openRowAddress = row;
+		(*ranks)[rank]->bankStates[bank].currentBankState = RowActive;
+		(*ranks)[rank]->bankStates[bank].openRowAddress = row;
+	}
+}
+
 void MemoryController::resetStats()
 {
 	for (size_t i=0; i<NUM_RANKS; i++)
@@ -792,17 +1030,34 @@ void MemoryController::resetStats()
 			totalEpochLatency[SEQUENTIAL(i,j)] = 0;
 		}
 
-		burstEnergy[i] = 0;
-		actpreEnergy[i] = 0;
-		refreshEnergy[i] = 0;
-		backgroundEnergy[i] = 0;
 		totalReadsPerRank[i] = 0;
 		totalWritesPerRank[i] = 0;
 	}
+	epochLatencies.reset();
+	powerModel->reset(currentClockCycle);
+	for (size_t i=0; i<NUM_RANKS*NUM_BANKS; i++)
+	{
+		rowHits[i] = 0;
+		rowMisses[i] = 0;
+		rowConflicts[i] = 0;
+		bankBusyCycles[i] = 0;
+	}
+	for (size_t i=0; i<commandCounts.size(); i++)
+	{
+		commandCounts[i] = 0;
+	}
+	readToWriteTurnarounds = 0;
+	writeToReadTurnarounds = 0;
+	for (size_t i=0; i<breakdownLatencies.size(); i++)
+	{
+		breakdownLatencies[i].reset();
+		totalBreakdownLatency[i] = 0;
+	}
 }
 //prints statistics at the end of an epoch or  simulation
 void MemoryController::printStats(bool finalStats)
 {
+	PROFILE_SCOPE(StatsOutput)
 	unsigned myChannel = parentMemorySystem->systemID;
 
 	//if we are not at the end of the epoch, make sure to adjust for the actual number of cycles elapsed
@@ -849,6 +1104,7 @@ void MemoryController::printStats(bool finalStats)
 	PRINT( " ("<<totalBytesTransferred <<" bytes) aggregate average bandwidth "<<totalBandwidth<<"GB/s");
 
 	double totalAggregateBandwidth = 0.0;	
+	double totalEnergy = 0.0;
 	for (size_t r=0;r<NUM_RANKS;r++)
 	{
 
@@ -862,12 +1118,22 @@ void MemoryController::printStats(bool finalStats)
 			PRINT( "        -Bandwidth / Latency  (Bank " <<j<<"): " <<bandwidth[SEQUENTIAL(r,j)] << " GB/s\t\t" <<averageLatency[SEQUENTIAL(r,j)] << " ns");
 		}
 
-		// factor of 1000 at the end is to account for the fact that totalEnergy is accumulated in mJ since IDD values are given in mA
-		backgroundPower[r] = ((double)backgroundEnergy[r] / (double)(cyclesElapsed)) * Vdd / 1000.0;
-		burstPower[r] = ((double)burstEnergy[r] / (double)(cyclesElapsed)) * Vdd / 1000.0;
-		refreshPower[r] = ((double) refreshEnergy[r] / (double)(cyclesElapsed)) * Vdd / 1000.0;
-		actprePower[r] = ((double)actpreEnergy[r] / (double)(cyclesElapsed)) * Vdd / 1000.0;
-		averagePower[r] = ((backgroundEnergy[r] + burstEnergy[r] + refreshEnergy[r] + actpreEnergy[r]) / (double)cyclesElapsed) * Vdd / 1000.0;
+		// energy is in pJ, so dividing by the time in ns gives mW
+		const PowerModel::Energy &energy = powerModel->getEnergy(r, currentClockCycle);
+		double nsElapsed = cyclesElapsed * tCK;
+		backgroundPower[r] = energy.background / nsElapsed / 1000.0;
+		burstPower[r] = energy.burst / nsElapsed / 1000.0;
+		refreshPower[r] = energy.refresh / nsElapsed / 1000.0;
+		actprePower[r] = energy.actpre / nsElapsed / 1000.0;
+		averagePower[r] = energy.total() / nsElapsed / 1000.0;
+		totalEnergy += energy.total();
+
+		// the energy counters in their old unit, mA * cycles summed over the devices
+		double toCurrentCycles = 1.0 / (Vdd * tCK);
+		backgroundEnergy[r] = (uint64_t)(energy.background * toCurrentCycles + 0.5);
+		burstEnergy[r] = (uint64_t)(energy.burst * toCurrentCycles + 0.5);
+		refreshEnergy[r] = (uint64_t)(energy.refresh * toCurrentCycles + 0.5);
+		actpreEnergy[r] = (uint64_t)(energy.actpre * toCurrentCycles + 0.5);
 
 		if ((*parentMemorySystem->ReportPower)!=NULL)
 		{
@@ -880,50 +1146,192 @@ void MemoryController::printStats(bool finalStats)
 		PRINT( "     -Act/Pre    (watts)     : " << actprePower[r] );
 		PRINT( "     -Burst      (watts)     : " << burstPower[r]);
 		PRINT( "     -Refresh    (watts)     : " << refreshPower[r] );
+		PRINTN( "     -Residency              :");
+		for (size_t i=0; i<PowerModel::NUM_RANK_STATES; i++)
+		{
+			double residency = (double)powerModel->getResidency(r, (PowerModel::RankState)i) / cyclesElapsed;
+			PRINTN( " " << PowerModel::rankStateNames[i] << "=" << residency*100.0 << "%");
+			if (VIS_FILE_OUTPUT)
+			{
+				statsOut.set(residencyColumn[r*PowerModel::NUM_RANK_STATES + i], residency);
+			}
+		}
+		PRINT( "" );
 
 		if (VIS_FILE_OUTPUT)
 		{
-		//	cout << "c="<<myChannel<< " r="<<r<<"writing to csv out on cycle "<< currentClockCycle<<endl;
 			// write the vis file output
-			csvOut << CSVWriter::IndexedName("Background_Power",myChannel,r) <<backgroundPower[r];
-			csvOut << CSVWriter::IndexedName("ACT_PRE_Power",myChannel,r) << actprePower[r];
-			csvOut << CSVWriter::IndexedName("Burst_Power",myChannel,r) << burstPower[r];
-			csvOut << CSVWriter::IndexedName("Refresh_Power",myChannel,r) << refreshPower[r];
+			statsOut.set(backgroundPowerColumn[r], backgroundPower[r]);
+			statsOut.set(actprePowerColumn[r], actprePower[r]);
+			statsOut.set(burstPowerColumn[r], burstPower[r]);
+			statsOut.set(refreshPowerColumn[r], refreshPower[r]);
 			double totalRankBandwidth=0.0;
 			for (size_t b=0; b<NUM_BANKS; b++)
 			{
-				csvOut << CSVWriter::IndexedName("Bandwidth",myChannel,r,b) << bandwidth[SEQUENTIAL(r,b)];
+				statsOut.set(bandwidthColumn[SEQUENTIAL(r,b)], bandwidth[SEQUENTIAL(r,b)]);
 				totalRankBandwidth += bandwidth[SEQUENTIAL(r,b)];
 				totalAggregateBandwidth += bandwidth[SEQUENTIAL(r,b)];
-				csvOut << CSVWriter::IndexedName("Average_Latency",myChannel,r,b) << averageLatency[SEQUENTIAL(r,b)];
+				statsOut.set(averageLatencyColumn[SEQUENTIAL(r,b)], averageLatency[SEQUENTIAL(r,b)]);
 			}
-			csvOut << CSVWriter::IndexedName("Rank_Aggregate_Bandwidth",myChannel,r) << totalRankBandwidth; 
-			csvOut << CSVWriter::IndexedName("Rank_Average_Bandwidth",myChannel,r) << totalRankBandwidth/NUM_RANKS; 
+			statsOut.set(rankAggregateBandwidthColumn[r], totalRankBandwidth);
+			statsOut.set(rankAverageBandwidthColumn[r], totalRankBandwidth/NUM_RANKS);
 		}
 	}
 	if (VIS_FILE_OUTPUT)
 	{
-		csvOut << CSVWriter::IndexedName("Aggregate_Bandwidth",myChannel) << totalAggregateBandwidth;
-		csvOut << CSVWriter::IndexedName("Average_Bandwidth",myChannel) << totalAggregateBandwidth / (NUM_RANKS*NUM_BANKS);
+		statsOut.set(aggregateBandwidthColumn, totalAggregateBandwidth);
+		statsOut.set(averageBandwidthColumn, totalAggregateBandwidth / (NUM_RANKS*NUM_BANKS));
+	}
+
+	uint64_t counts[NUM_COMMAND_COUNTS];
+	counts[ActivateCount] = commandCounts[ACTIVATE];
+	counts[PrechargeCount] = commandCounts[PRECHARGE];
+	counts[ReadCount] = commandCounts[READ] + commandCounts[READ_P];
+	counts[WriteCount] = commandCounts[WRITE] + commandCounts[WRITE_P];
+	counts[RefreshCount] = commandCounts[REFRESH];
+	uint64_t totalCommands = 0;
+	for (size_t i=0; i<NUM_COMMAND_COUNTS; i++)
+	{
+		totalCommands += counts[i];
+	}
+	uint64_t totalBursts = 0;
+	for (size_t i=0; i<NUM_RANKS*NUM_BANKS; i++)
+	{
+		totalBursts += totalReadsPerBank[i] + totalWritesPerBank[i];
+	}
+	double commandBusUtilization = (double)(totalCommands * tCMD) / cyclesElapsed;
+	double dataBusUtilization = (double)(totalBursts * (BL/2)) / cyclesElapsed;
+
+	PRINT( " == Row Buffer / Bank Usage" );
+	for (size_t r=0;r<NUM_RANKS;r++)
+	{
+		for (size_t b=0;b<NUM_BANKS;b++)
+		{
+			double bankUtilization = (double)bankBusyCycles[SEQUENTIAL(r,b)] / cyclesElapsed;
+			PRINT( "     -Rank "<<r<<" Bank "<<b<<" : hits="<<rowHits[SEQUENTIAL(r,b)]<<" misses="<<rowMisses[SEQUENTIAL(r,b)]
+					<<" conflicts="<<rowConflicts[SEQUENTIAL(r,b)]<<" busy="<<bankUtilization*100.0<<"%");
+			if (VIS_FILE_OUTPUT)
+			{
+				statsOut.set(rowHitsColumn[SEQUENTIAL(r,b)], rowHits[SEQUENTIAL(r,b)]);
+				statsOut.set(rowMissesColumn[SEQUENTIAL(r,b)], rowMisses[SEQUENTIAL(r,b)]);
+				statsOut.set(rowConflictsColumn[SEQUENTIAL(r,b)], rowConflicts[SEQUENTIAL(r,b)]);
+				statsOut.set(bankUtilizationColumn[SEQUENTIAL(r,b)], bankUtilization);
+			}
+		}
+	}
+	double energyPerBit = totalBursts == 0 ? 0.0 : totalEnergy / (totalBursts * bytesPerTransaction * 8.0);
+	PRINT( " == Energy per bit (pJ)        : " << energyPerBit );
+	if (VIS_FILE_OUTPUT)
+	{
+		statsOut.set(energyPerBitColumn, energyPerBit);
+	}
+	PRINT( " == Bus Utilization            : command="<<commandBusUtilization*100.0<<"% data="<<dataBusUtilization*100.0
+			<<"%  turnarounds R->W="<<readToWriteTurnarounds<<" W->R="<<writeToReadTurnarounds);
+	PRINTN( " == Commands                   :");
+	for (size_t i=0; i<NUM_COMMAND_COUNTS; i++)
+	{
+		PRINTN( " " << commandCountNames[i] << "=" << counts[i]);
+	}
+	PRINT( "" );
+	if (VIS_FILE_OUTPUT)
+	{
+		statsOut.set(commandBusUtilizationColumn, commandBusUtilization);
+		statsOut.set(dataBusUtilizationColumn, dataBusUtilization);
+		statsOut.set(readToWriteColumn, readToWriteTurnarounds);
+		statsOut.set(writeToReadColumn, writeToReadTurnarounds);
+		for (size_t i=0; i<NUM_COMMAND_COUNTS; i++)
+		{
+			statsOut.set(commandCountColumn[i], counts[i]);
+		}
+	}
+
+	epochSummary.bandwidth = totalBandwidth;
+	epochSummary.latencyP50 = epochLatencies.percentile(50.0) * tCK;
+	epochSummary.latencyP90 = epochLatencies.percentile(90.0) * tCK;
+	epochSummary.latencyP99 = epochLatencies.percentile(99.0) * tCK;
+	epochSummary.latencyMax = epochLatencies.max() * tCK;
+	epochSummary.reads = counts[ReadCount];
+	epochSummary.writes = counts[WriteCount];
+	epochSummary.transactionQueueSize = transactionQueue.size();
+	epochSummary.pendingReads = pendingReadTransactions.size();
+
+	PRINTN( " == Read Latency (ns)         :");
+	for (size_t i=0; i<NUM_LATENCY_PERCENTILES; i++)
+	{
+		double latency = epochLatencies.percentile(latencyPercentiles[i]) * tCK;
+		PRINTN( " " << latencyPercentileNames[i] << "=" << latency);
+		if (VIS_FILE_OUTPUT)
+		{
+			statsOut.set(latencyPercentileColumn[i], latency);
+		}
+	}
+	PRINT( "" );
+	if (LATENCY_BREAKDOWN)
+	{
+		PRINT( " == Read Latency Breakdown (ns) [" << breakdownLatencies[DataLatency].count() << " reads]");
+		for (size_t i=0; i<NUM_LATENCY_COMPONENTS; i++)
+		{
+			uint64_t count = breakdownLatencies[i].count();
+			double mean = count == 0 ? 0.0 : (double)totalBreakdownLatency[i] / count * tCK;
+			double p99 = breakdownLatencies[i].percentile(99.0) * tCK;
+			PRINT( "     -" << latencyComponentNames[i] << "\t: mean=" << mean << " p50=" << breakdownLatencies[i].percentile(50.0) * tCK
+					<< " p99=" << p99 << " max=" << breakdownLatencies[i].max() * tCK );
+			if (VIS_FILE_OUTPUT)
+			{
+				statsOut.set(breakdownMeanColumn[i], mean);
+				statsOut.set(breakdownP99Column[i], p99);
+			}
+		}
 	}
 
 	// only print the latency histogram at the end of the simulation since it clogs the output too much to print every epoch
 	if (finalStats)
 	{
-		PRINT( " ---  Latency list ("<<latencies.size()<<")");
+		PRINTN( " == Read Latency, whole run (ns):");
+		for (size_t i=0; i<NUM_LATENCY_PERCENTILES; i++)
+		{
+			PRINTN( " " << latencyPercentileNames[i] << "=" << latencies.percentile(latencyPercentiles[i]) * tCK);
+		}
+		PRINT( "" );
+		if (PER_BANK_LATENCY_HISTOGRAMS)
+		{
+			for (size_t r=0; r<NUM_RANKS; r++)
+			{
+				LatencyHistogram rankLatencies(HISTOGRAM_PRECISION);
+				for (size_t b=0; b<NUM_BANKS; b++)
+				{
+					rankLatencies.merge(bankLatencies[SEQUENTIAL(r,b)]);
+				}
+				PRINTN( "      -Rank   "<<r<<" (ns)      :");
+				for (size_t i=0; i<NUM_LATENCY_PERCENTILES; i++)
+				{
+					PRINTN( " " << latencyPercentileNames[i] << "=" << rankLatencies.percentile(latencyPercentiles[i]) * tCK);
+				}
+				PRINT( "" );
+				for (size_t b=0; b<NUM_BANKS; b++)
+				{
+					PRINTN( "        -Bank " << b << " (ns)    :");
+					for (size_t i=0; i<NUM_LATENCY_PERCENTILES; i++)
+					{
+						PRINTN( " " << latencyPercentileNames[i] << "=" << bankLatencies[SEQUENTIAL(r,b)].percentile(latencyPercentiles[i]) * tCK);
+					}
+					PRINT( "" );
+				}
+			}
+		}
+
+		PRINT( " ---  Latency list ("<<latencies.count()<<")");
 		PRINT( "       [lat] : #");
 		if (VIS_FILE_OUTPUT)
 		{
-			csvOut.getOutputStream() << "!!HISTOGRAM_DATA"<<endl;
+			statsOut.writeHistogram(myChannel, latencies);
 		}
 
-		map<unsigned,unsigned>::iterator it; //
-		for (it=latencies.begin(); it!=latencies.end(); it++)
+		for (size_t i=0; i<latencies.numBins(); i++)
 		{
-			PRINT( "       ["<< it->first <<"-"<<it->first+(HISTOGRAM_BIN_SIZE-1)<<"] : "<< it->second );
-			if (VIS_FILE_OUTPUT)
+			if (latencies.binCount(i) > 0)
 			{
-				csvOut.getOutputStream() << it->first <<"="<< it->second << endl;
+				PRINT( "       ["<< latencies.binLowerBound(i) <<"-"<<latencies.binUpperBound(i)<<"] : "<< latencies.binCount(i) );
 			}
 		}
 		if (currentClockCycle % EPOCH_LENGTH == 0)
@@ -967,12 +1375,303 @@ MemoryController::~MemoryController()
 	{
 		delete returnTransaction[i];
 	}
+	delete powerModel;
+}
+//a bank counts as open for the background power while a row is open or it is refreshing
+static bool isBankOpen(CurrentBankState state)
+{
+	return state == RowActive || state == Refreshing;
+}
 
+//change the state of a bank and tell the power model if the rank's number of open banks changed
+void MemoryController::setBankState(unsigned rank, unsigned bank, CurrentBankState state)
+{
+	bool wasOpen = isBankOpen(bankStates[rank][bank].currentBankState);
+	bankStates[rank][bank].currentBankState = state;
+	if (wasOpen != isBankOpen(state))
+	{
+		if (wasOpen)
+		{
+			openBanks[rank]--;
+		}
+		else
+		{
+			openBanks[rank]++;
+		}
+		updateRankPowerState(rank);
+	}
+}
+
+//the background power state of a rank changes with its open banks and power down
+void MemoryController::updateRankPowerState(unsigned rank)
+{
+	PowerModel::RankState state;
+	if (openBanks[rank] > 0)
+	{
+		state = powerDown[rank] ? PowerModel::ActivePowerDown : PowerModel::ActiveStandby;
+	}
+	else
+	{
+		state = powerDown[rank] ? PowerModel::PrechargePowerDown : PowerModel::PrechargeStandby;
+	}
+	if (DEBUG_POWER && state != rankPowerState[rank])
+	{
+		PRINT(" ++ Rank " << rank << " is now in " << PowerModel::rankStateNames[state] << " [" << openBanks[rank] << " banks open]");
+	}
+	rankPowerState[rank] = state;
+	powerModel->setRankState(rank, state, openBanks[rank], currentClockCycle);
+}
+
+//bandwidth, latency and queue occupancy of the last epoch
+const LiveStatsChannel &MemoryController::getEpochSummary() const
+{
+	return epochSummary;
 }
+
+//read latency histogram (in cycles)
+const LatencyHistogram &MemoryController::getLatencyHistogram() const
+{
+	return latencies;
+}
+
+void MemoryController::resetLatencyHistogram()
+{
+	latencies.reset();
+}
+
+/*
+ * Counts every command and classifies each column access as a row hit (no
+ * ACT was needed), a miss (the bank was closed) or a conflict (the bank was
+ * closed because a waiting request needed another row). Precharges that
+ * make way for a refresh or close an idle row don't cause a conflict.
+ */
+void MemoryController::updateRowBufferStats(const BusPacket *packet)
+{
+	unsigned seq = SEQUENTIAL(packet->rank,packet->bank);
+	commandCounts[packet->busPacketType]++;
+	switch (packet->busPacketType)
+	{
+		case PRECHARGE:
+			conflictPending[seq] = !(*ranks)[packet->rank]->refreshWaiting &&
+				commandQueue.hasCommandsFor(packet->rank, packet->bank);
+			break;
+		case ACTIVATE:
+			if (conflictPending[seq])
+			{
+				rowConflicts[seq]++;
+			}
+			else
+			{
+				rowMisses[seq]++;
+			}
+			conflictPending[seq] = false;
+			activatePending[seq] = true;
+			break;
+		case READ:
+		case READ_P:
+		case WRITE:
+		case WRITE_P:
+			if (activatePending[seq])
+			{
+				activatePending[seq] = false;
+			}
+			else
+			{
+				rowHits[seq]++;
+			}
+			if (isWriteCommand(packet->busPacketType) && (lastColumnCommand == READ || lastColumnCommand == READ_P))
+			{
+				readToWriteTurnarounds++;
+			}
+			else if (!isWriteCommand(packet->busPacketType) && isWriteCommand(lastColumnCommand))
+			{
+				writeToReadTurnarounds++;
+			}
+			lastColumnCommand = packet->busPacketType;
+			break;
+		default:
+			break;
+	}
+}
+
+/*
+ * Timestamps the read an ACT or CAS was made for. When it is the read's
+ * first command, the time it waited in the command queue is split into the
+ * part that overlapped a refresh of its rank and the part spent after a
+ * precharge closed another row in its bank.
+ */
+void MemoryController::recordCommandIssue(const BusPacket *packet)
+{
+	unsigned rank = packet->rank;
+	unsigned bank = packet->bank;
+	switch (packet->busPacketType)
+	{
+		case PRECHARGE:
+			lastPrechargeCycle[SEQUENTIAL(rank,bank)] = currentClockCycle;
+			return;
+		case REFRESH:
+			refreshEndCycle[rank] = currentClockCycle + tRFC;
+			return;
+		default:
+			break;
+	}
+
+	Transaction *trans = packet->transaction;
+	if (trans == NULL)
+	{
+		return;
+	}
+	bool firstCommand = trans->timeActivated == 0;
+	if (packet->busPacketType == ACTIVATE)
+	{
+		trans->timeActivated = currentClockCycle;
+	}
+	else
+	{
+		trans->timeCASIssued = currentClockCycle;
+	}
+	if (!firstCommand)
+	{
+		return;
+	}
+
+	uint64_t refreshStart = max(trans->timeCommandQueued, refreshRequestCycle[rank]);
+	uint64_t refreshEnd = min(currentClockCycle, refreshEndCycle[rank]);
+	trans->refreshCycles = refreshEnd > refreshStart ? refreshEnd - refreshStart : 0;
+
+	// precharges issued for the refresh itself don't count as a conflict
+	uint64_t prechargeCycle = lastPrechargeCycle[SEQUENTIAL(rank,bank)];
+	if (packet->busPacketType == ACTIVATE && prechargeCycle >= trans->timeCommandQueued && prechargeCycle >= refreshEndCycle[rank])
+	{
+		trans->prechargeCycles = currentClockCycle - prechargeCycle;
+	}
+}
+
+void MemoryController::insertLatencyBreakdown(const Transaction *trans)
+{
+	uint64_t components[NUM_LATENCY_COMPONENTS];
+	uint64_t firstCommand = trans->timeActivated != 0 ? trans->timeActivated : trans->timeCASIssued;
+	uint64_t wait = firstCommand - trans->timeCommandQueued;
+
+	components[TransactionQueueLatency] = trans->timeCommandQueued - trans->timeAdded;
+	components[RefreshLatency] = min(trans->refreshCycles, wait);
+	components[PrechargeLatency] = min(trans->prechargeCycles, wait - components[RefreshLatency]);
+	components[CommandQueueLatency] = wait - components[RefreshLatency] - components[PrechargeLatency];
+	components[ActivateLatency] = trans->timeActivated != 0 ? trans->timeCASIssued - trans->timeActivated : 0;
+	components[DataLatency] = currentClockCycle - trans->timeCASIssued;
+
+	for (size_t i=0; i<NUM_LATENCY_COMPONENTS; i++)
+	{
+		breakdownLatencies[i].insert(components[i]);
+		totalBreakdownLatency[i] += components[i];
+	}
+}
+
 //inserts a latency into the latency histogram
 void MemoryController::insertHistogram(unsigned latencyValue, unsigned rank, unsigned bank)
 {
 	totalEpochLatency[SEQUENTIAL(rank,bank)] += latencyValue;
-	//poor man's way to bin things.
-	latencies[(latencyValue/HISTOGRAM_BIN_SIZE)*HISTOGRAM_BIN_SIZE]++;
+	latencies.insert(latencyValue);
+	epochLatencies.insert(latencyValue);
+	if (PER_BANK_LATENCY_HISTOGRAMS)
+	{
+		bankLatencies[SEQUENTIAL(rank,bank)].insert(latencyValue);
+	}
+}
+
+//everything that changes while simulating, including the epoch statistics;
+//the transactions go before the commands that may point to them
+void MemoryController::checkpoint(Checkpoint &cp)
+{
+	cp.io(currentClockCycle);
+	cp.io(transactionQueue);
+	cp.io(pendingReadTransactions);
+	cp.io(returnTransaction);
+
+	cp.section("CMDQ");
+	unsigned savedPolicy = rowBufferPolicy;
+	cp.io(savedPolicy);
+	commandQueue.checkpoint(cp);
+	cp.checkSize(bankStates.size());
+	bool rowsOpen = false;
+	for (size_t i=0; i<bankStates.size(); i++)
+	{
+		cp.checkSize(bankStates[i].size());
+		for (size_t j=0; j<bankStates[i].size(); j++)
+		{
+			bankStates[i][j].checkpoint(cp);
+			rowsOpen = rowsOpen || bankStates[i][j].currentBankState == RowActive;
+		}
+	}
+	//queued column commands were made for the saved policy (only close page
+	//auto-precharges) and close page never closes a row itself, so the policy
+	//can only change while there are no commands and no open rows
+	if (!cp.isSaving() && savedPolicy != (unsigned)rowBufferPolicy)
+	{
+		bool commandsQueued = false;
+		for (size_t i=0; i<NUM_RANKS; i++)
+		{
+			commandsQueued = commandsQueued || !commandQueue.isEmpty(i);
+		}
+		if (commandsQueued || rowsOpen)
+		{
+			ERROR("Checkpoint was saved with a different ROW_BUFFER_POLICY and has commands queued or rows open");
+			exit(-1);
+		}
+	}
+	cp.io(refreshCountdown);
+	cp.io(refreshRank);
+	cp.io(writeDataToSend, dramsim_log);
+	cp.io(writeDataCountdown);
+	cp.io(outgoingCmdPacket, dramsim_log);
+	cp.io(cmdCyclesLeft);
+	cp.io(outgoingDataPacket, dramsim_log);
+	cp.io(dataCyclesLeft);
+	cp.io(powerDown);
+	cp.io(openBanks);
+	cp.io(rankPowerState);
+	cp.io(completedTransactions);
+
+	cp.section("STAT");
+	latencies.checkpoint(cp);
+	epochLatencies.checkpoint(cp);
+	cp.checkSize(bankLatencies.size());
+	for (size_t i=0; i<bankLatencies.size(); i++)
+	{
+		bankLatencies[i].checkpoint(cp);
+	}
+	cp.checkSize(breakdownLatencies.size());
+	for (size_t i=0; i<breakdownLatencies.size(); i++)
+	{
+		breakdownLatencies[i].checkpoint(cp);
+	}
+	cp.io(totalBreakdownLatency);
+	cp.io(refreshRequestCycle);
+	cp.io(refreshEndCycle);
+	cp.io(lastPrechargeCycle);
+	cp.io(rowHits);
+	cp.io(rowMisses);
+	cp.io(rowConflicts);
+	cp.io(bankBusyCycles);
+	cp.io(activatePending);
+	cp.io(conflictPending);
+	cp.io(commandCounts);
+	cp.io(readToWriteTurnarounds);
+	cp.io(writeToReadTurnarounds);
+	cp.io(lastColumnCommand);
+	cp.io(epochSummary);
+	cp.io(totalTransactions);
+	cp.io(grandTotalBankAccesses);
+	cp.io(totalReadsPerBank);
+	cp.io(totalWritesPerBank);
+	cp.io(totalReadsPerRank);
+	cp.io(totalWritesPerRank);
+	cp.io(totalEpochLatency);
+	cp.io(backgroundEnergy);
+	cp.io(burstEnergy);
+	cp.io(actpreEnergy);
+	cp.io(refreshEnergy);
+
+	cp.section("POWR");
+	powerModel->checkpoint(cp);
 }
@@ -44,7 +44,12 @@
 #include "BusPacket.h"
 #include "BankState.h"
 #include "Rank.h"
-#include "CSVWriter.h"
+#include "StatsWriter.h"
+#include "LatencyHistogram.h"
+#include "LiveStats.h"
+#include "CommandTrace.h"
+#include "PowerModel.h"
+#include "CompletionQueue.h"
 #include <map>
 
 using namespace std;
@@ -52,12 +57,13 @@ using namespace std;
 namespace DRAMSim
 {
 class MemorySystem;
+class Checkpoint;
 class MemoryController : public SimulatorObject
 {
 
 public:
 	//functions
-	MemoryController(MemorySystem* ms, CSVWriter &csvOut_, ostream &dramsim_log_);
+	MemoryController(MemorySystem* ms, StatsWriter &statsOut_, ostream &dramsim_log_);
 	virtual ~MemoryController();
 
 	bool addTransaction(Transaction *trans);
@@ -68,15 +74,31 @@ public:
 	void update();
 	void printStats(bool finalStats = false);
 	void resetStats(); 
+	const LatencyHistogram &getLatencyHistogram() const;
+	const LiveStatsChannel &getEpochSummary() const;
+	void resetLatencyHistogram();
+	bool isIdle();
+	void fastForward(uint64_t cycles);
+	void functionalAccess(uint64_t address);
+	void checkpoint(Checkpoint &cp);
 
 
 	//fields
 	vector<Transaction *> transactionQueue;
+	BusLog *busLog; // only with BUS_LOG
+	CommandTrace *commandTrace; // only with COMMAND_TRACE, owned by the MemorySystem
+	uint64_t completedTransactions; // read returns and write completions, never reset
+	CompletionQueue *completionQueue; // only after enableCompletionQueue(), owned by the MultiChannelMemorySystem
 private:
 	ostream &dramsim_log;
 	vector< vector <BankState> > bankStates;
 	//functions
 	void insertHistogram(unsigned latencyValue, unsigned rank, unsigned bank);
+	void recordCommandIssue(const BusPacket *packet);
+	void insertLatencyBreakdown(const Transaction *trans);
+	void updateRowBufferStats(const BusPacket *packet);
+	void setBankState(unsigned rank, unsigned bank, CurrentBankState state);
+	void updateRankPowerState(unsigned rank);
 
 	//fields
 	MemorySystem *parentMemorySystem;
@@ -88,13 +110,67 @@ private:
 	vector<unsigned> writeDataCountdown;
 	vector<Transaction *> returnTransaction;
 	vector<Transaction *> pendingReadTransactions;
-	map<unsigned,unsigned> latencies; // latencyValue -> latencyCount
+	LatencyHistogram latencies; // whole simulation (or since resetLatencyHistogram())
+	LatencyHistogram epochLatencies;
+	vector<LatencyHistogram> bankLatencies; // only with PER_BANK_LATENCY_HISTOGRAMS
+
+	// only with LATENCY_BREAKDOWN: one histogram per latency component for
+	// the current epoch and the cycles needed to split the queueing time
+	vector<LatencyHistogram> breakdownLatencies;
+	vector<uint64_t> totalBreakdownLatency;
+	vector<uint64_t> refreshRequestCycle;
+	vector<uint64_t> refreshEndCycle;
+	vector<uint64_t> lastPrechargeCycle;
+
+	// row buffer locality, bank and bus usage for the current epoch
+	vector<uint64_t> rowHits;
+	vector<uint64_t> rowMisses; // row was closed
+	vector<uint64_t> rowConflicts; // another row had to be closed first
+	vector<uint64_t> bankBusyCycles;
+	vector<bool> activatePending; // an ACT was issued and its CAS hasn't been yet
+	vector<bool> conflictPending; // the bank was closed for a waiting request
+	vector<uint64_t> commandCounts; // indexed by BusPacketType
+	uint64_t readToWriteTurnarounds;
+	uint64_t writeToReadTurnarounds;
+	BusPacketType lastColumnCommand;
 	vector<bool> powerDown;
+	PowerModel *powerModel;
+	vector<unsigned> openBanks; // per rank, banks with an open row or refreshing
+	vector<PowerModel::RankState> rankPowerState;
 
 	vector<Rank *> *ranks;
 
 	//output file
-	CSVWriter &csvOut; 
+	StatsWriter &statsOut;
+
+	// vis file columns, registered once in the constructor
+	vector<unsigned> backgroundPowerColumn;
+	vector<unsigned> actprePowerColumn;
+	vector<unsigned> burstPowerColumn;
+	vector<unsigned> refreshPowerColumn;
+	vector<unsigned> bandwidthColumn;
+	vector<unsigned> averageLatencyColumn;
+	vector<unsigned> rankAggregateBandwidthColumn;
+	vector<unsigned> rankAverageBandwidthColumn;
+	unsigned aggregateBandwidthColumn;
+	unsigned averageBandwidthColumn;
+	vector<unsigned> latencyPercentileColumn;
+	vector<unsigned> breakdownMeanColumn;
+	vector<unsigned> breakdownP99Column;
+	vector<unsigned> rowHitsColumn;
+	vector<unsigned> rowMissesColumn;
+	vector<unsigned> rowConflictsColumn;
+	vector<unsigned> bankUtilizationColumn;
+	unsigned commandBusUtilizationColumn;
+	unsigned dataBusUtilizationColumn;
+	unsigned readToWriteColumn;
+	unsigned writeToReadColumn;
+	vector<unsigned> commandCountColumn;
+	unsigned energyPerBitColumn;
+	vector<unsigned> residencyColumn;
+
+	// headline numbers of the last printStats(), for live monitoring
+	LiveStatsChannel epochSummary;
 
 	// these packets are counting down waiting to be transmitted on the "bus"
 	BusPacket *outgoingCmdPacket;
@@ -125,6 +201,7 @@ private:
 	
 public:
 	// energy values are per rank -- SST uses these directly, so make these public 
+	// (in mA * cycles over all devices of the rank, set by printStats() from the power model)
 	vector< uint64_t > backgroundEnergy;
 	vector< uint64_t > burstEnergy;
 	vector< uint64_t > actpreEnergy;
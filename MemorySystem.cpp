@@ -38,6 +38,7 @@
 
 #include "MemorySystem.h"
 #include "IniReader.h"
+#include "Checkpoint.h"
 #include <unistd.h>
 
 using namespace std;
@@ -53,12 +54,16 @@ namespace DRAMSim {
 
 powerCallBack_t MemorySystem::ReportPower = NULL;
 
-MemorySystem::MemorySystem(unsigned id, unsigned int megsOfMemory, CSVWriter &csvOut_, ostream &dramsim_log_) :
+MemorySystem::MemorySystem(unsigned id, unsigned int megsOfMemory, StatsWriter &statsOut_, ostream &dramsim_log_) :
 		dramsim_log(dramsim_log_),
+		commandTrace(NULL),
+		fastModel(NULL),
+		fastMode(false),
 		ReturnReadData(NULL),
 		WriteDataDone(NULL),
 		systemID(id),
-		csvOut(csvOut_)
+		statsOut(statsOut_),
+		skippedCycles(0)
 {
 	currentClockCycle = 0;
 
@@ -130,7 +135,7 @@ MemorySystem::MemorySystem(unsigned id, unsigned int megsOfMemory, CSVWriter &cs
 	DEBUG("CH. " <<systemID<<" TOTAL_STORAGE : "<< TOTAL_STORAGE << "MB | "<<NUM_RANKS<<" Ranks | "<< NUM_DEVICES <<" Devices per rank");
 
 
-	memoryController = new MemoryController(this, csvOut, dramsim_log);
+	memoryController = new MemoryController(this, statsOut, dramsim_log);
 
 	// TODO: change to other vector constructor?
 	ranks = new vector<Rank *>();
@@ -145,6 +150,10 @@ MemorySystem::MemorySystem(unsigned id, unsigned int megsOfMemory, CSVWriter &cs
 
 	memoryController->attachRanks(ranks);
 
+	if (memoryModelType == FastModel)
+	{
+		setFastMode(true);
+	}
 }
 
 
@@ -156,6 +165,8 @@ MemorySystem::~MemorySystem()
 //	abort();
 
 	delete(memoryController);
+	delete commandTrace;
+	delete fastModel;
 
 	for (size_t i=0; i<NUM_RANKS; i++)
 	{
@@ -173,19 +184,24 @@ MemorySystem::~MemorySystem()
 
 bool MemorySystem::WillAcceptTransaction()
 {
+	if (fastMode)
+	{
+		return fastModel->willAcceptTransaction();
+	}
 	return memoryController->WillAcceptTransaction();
 }
 
-bool MemorySystem::addTransaction(bool isWrite, uint64_t addr)
+bool MemorySystem::addTransaction(bool isWrite, uint64_t addr, uint64_t tag)
 {
 	TransactionType type = isWrite ? DATA_WRITE : DATA_READ;
 	Transaction *trans = new Transaction(type,addr,NULL);
+	trans->tag = tag;
 	// push_back in memoryController will make a copy of this during
 	// addTransaction so it's kosher for the reference to be local 
 
-	if (memoryController->WillAcceptTransaction()) 
+	if (WillAcceptTransaction()) 
 	{
-		return memoryController->addTransaction(trans);
+		return addTransaction(trans);
 	}
 	else
 	{
@@ -196,22 +212,159 @@ bool MemorySystem::addTransaction(bool isWrite, uint64_t addr)
 
 bool MemorySystem::addTransaction(Transaction *trans)
 {
+	if (fastMode)
+	{
+		return fastModel->addTransaction(trans, currentClockCycle);
+	}
 	return memoryController->addTransaction(trans);
 }
 
 //prints statistics
 void MemorySystem::printStats(bool finalStats)
 {
+	catchUp();
 	memoryController->printStats(finalStats);
+	if (fastModel != NULL)
+	{
+		fastModel->printStats();
+	}
 }
 
 
+//no requests waiting or in flight
+bool MemorySystem::isIdle()
+{
+	return pendingTransactions.empty() && memoryController->isIdle() && (fastModel == NULL || fastModel->isIdle());
+}
+
+/*
+	Switches between the detailed model and the fast one (see
+	FastMemoryModel.h), also in the middle of a simulation: new requests go
+	to the model that is switched to, and the ones in flight finish in the
+	one they were sent to. While the fast model is used and the detailed
+	one has nothing to do, the detailed one is not updated; it catches up
+	with the skipped cycles the same way as for fastForward() and takes over
+	the rows the fast model left open.
+*/
+void MemorySystem::setFastMode(bool fast)
+{
+	if (fast && fastModel == NULL)
+	{
+		fastModel = new FastMemoryModel(this, dramsim_log);
+	}
+	if (!fast && fastMode)
+	{
+		catchUp();
+		if (rowBufferPolicy == OpenPage)
+		{
+			fastModel->openRows(memoryController);
+		}
+	}
+	fastMode = fast;
+}
+
+//bring the idle detailed model up to the current cycle
+void MemorySystem::catchUp()
+{
+	if (skippedCycles == 0)
+	{
+		return;
+	}
+	memoryController->fastForward(skippedCycles);
+	for (size_t i=0;i<NUM_RANKS;i++)
+	{
+		(*ranks)[i]->fastForward(skippedCycles);
+	}
+	skippedCycles = 0;
+}
+
+//log all bus traffic of this channel to busLog
+void MemorySystem::setBusLog(BusLog *busLog)
+{
+	memoryController->busLog = busLog;
+	for (size_t i=0; i<NUM_RANKS; i++)
+	{
+		(*ranks)[i]->busLog = busLog;
+		(*ranks)[i]->busLogChannel = systemID;
+	}
+}
+
+//keep the data stored in this channel in store
+void MemorySystem::setBackingStore(BackingStore *store)
+{
+	for (size_t i=0; i<NUM_RANKS; i++)
+	{
+		(*ranks)[i]->setBackingStore(store, systemID);
+	}
+}
+
+//write the commands of this channel to trace (which is deleted with the MemorySystem)
+void MemorySystem::setCommandTrace(CommandTrace *trace)
+{
+	delete commandTrace;
+	commandTrace = trace;
+	memoryController->commandTrace = trace;
+}
+
+//the state of the controller and the ranks of this channel
+void MemorySystem::checkpoint(Checkpoint &cp)
+{
+	if (fastMode || (fastModel != NULL && !fastModel->isIdle()))
+	{
+		ERROR("Checkpoints only cover the detailed model; switch the fast model off first");
+		abort();
+	}
+	cp.io(currentClockCycle);
+	cp.io(pendingTransactions);
+	memoryController->checkpoint(cp);
+	cp.checkSize(ranks->size());
+	for (size_t i=0; i<ranks->size(); i++)
+	{
+		cp.section("RANK");
+		(*ranks)[i]->checkpoint(cp);
+	}
+}
+
+//skip ahead without simulating the cycles in between (see MemoryController::fastForward)
+void MemorySystem::fastForward(uint64_t cycles)
+{
+	if (fastMode)
+	{
+		skippedCycles += cycles;
+		currentClockCycle += cycles;
+		return;
+	}
+	memoryController->fastForward(cycles);
+	for (size_t i=0;i<NUM_RANKS;i++)
+	{
+		(*ranks)[i]->fastForward(cycles);
+	}
+	currentClockCycle += cycles;
+}
+
 //update the memory systems state
 void MemorySystem::update()
 {
 
 	//PRINT(" ----------------- Memory System Update ------------------");
 
+	if (fastModel != NULL)
+	{
+		if (fastMode && pendingTransactions.size() > 0 && fastModel->willAcceptTransaction())
+		{
+			fastModel->addTransaction(pendingTransactions.front(), currentClockCycle);
+			pendingTransactions.pop_front();
+		}
+		fastModel->update(currentClockCycle);
+		//the detailed model only runs while it still has requests of its own
+		if (fastMode && memoryController->isIdle())
+		{
+			skippedCycles++;
+			this->step();
+			return;
+		}
+	}
+
 	//updates the state of each of the objects
 	// NOTE - do not change order
 	for (size_t i=0;i<NUM_RANKS;i++)
@@ -220,7 +373,7 @@ void MemorySystem::update()
 	}
 
 	//pendingTransactions will only have stuff in it if MARSS is adding stuff
-	if (pendingTransactions.size() > 0 && memoryController->WillAcceptTransaction())
+	if (!fastMode && pendingTransactions.size() > 0 && memoryController->WillAcceptTransaction())
 	{
 		memoryController->addTransaction(pendingTransactions.front());
 		pendingTransactions.pop_front();
@@ -44,7 +44,8 @@
 #include "Rank.h"
 #include "Transaction.h"
 #include "Callback.h"
-#include "CSVWriter.h"
+#include "StatsWriter.h"
+#include "FastMemoryModel.h"
 #include <deque>
 
 namespace DRAMSim
@@ -55,13 +56,20 @@ class MemorySystem : public SimulatorObject
 	ostream &dramsim_log;
 public:
 	//functions
-	MemorySystem(unsigned id, unsigned megsOfMemory, CSVWriter &csvOut_, ostream &dramsim_log_);
+	MemorySystem(unsigned id, unsigned megsOfMemory, StatsWriter &statsOut_, ostream &dramsim_log_);
 	virtual ~MemorySystem();
 	void update();
 	bool addTransaction(Transaction *trans);
-	bool addTransaction(bool isWrite, uint64_t addr);
+	bool addTransaction(bool isWrite, uint64_t addr, uint64_t tag);
 	void printStats(bool finalStats);
 	bool WillAcceptTransaction();
+	bool isIdle();
+	void fastForward(uint64_t cycles);
+	void setBusLog(BusLog *busLog);
+	void setBackingStore(BackingStore *store);
+	void setCommandTrace(CommandTrace *trace);
+	void setFastMode(bool fast);
+	void checkpoint(Checkpoint &cp);
 	void RegisterCallbacks(
 	    Callback_t *readDone,
 	    Callback_t *writeDone,
@@ -71,6 +79,9 @@ public:
 	MemoryController *memoryController;
 	vector<Rank *> *ranks;
 	deque<Transaction *> pendingTransactions; 
+	CommandTrace *commandTrace;
+	FastMemoryModel *fastModel; // only once fast mode was used
+	bool fastMode;
 
 
 	//function pointers
@@ -81,7 +92,9 @@ public:
 	unsigned systemID;
 
 private:
-	CSVWriter &csvOut;
+	void catchUp();
+	StatsWriter &statsOut;
+	uint64_t skippedCycles; // that the detailed model has not caught up with yet
 };
 }
 
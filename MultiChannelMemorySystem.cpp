@@ -37,6 +37,8 @@
 #include "MultiChannelMemorySystem.h"
 #include "AddressMapping.h"
 #include "IniReader.h"
+#include "SimProfiler.h"
+#include "Checkpoint.h"
 
 
 
@@ -48,7 +50,13 @@ MultiChannelMemorySystem::MultiChannelMemorySystem(const string &deviceIniFilena
 	systemIniFilename(systemIniFilename_), traceFilename(traceFilename_),
 	pwd(pwd_), visFilename(visFilename_), 
 	clockDomainCrosser(new ClockDomain::Callback<MultiChannelMemorySystem, void>(this, &MultiChannelMemorySystem::actual_update)),
-	csvOut(new CSVWriter(visDataOut))
+	statsOut(NULL),
+	liveStats(NULL),
+	asyncLog(NULL),
+	savedLogBuffer(NULL),
+	busLog(NULL),
+	backingStore(NULL),
+	completionQueue(NULL)
 {
 	currentClockCycle=0; 
 	if (visFilename)
@@ -94,21 +102,53 @@ MultiChannelMemorySystem::MultiChannelMemorySystem(const string &deviceIniFilena
 		ERROR("Zero channels"); 
 		abort(); 
 	}
+	// the time is the first column of the vis file, each channel adds its own after it
+	statsOut = new StatsWriter(visDataOut, visFileFormat);
+	timeColumn = statsOut->addColumn("ms");
 	for (size_t i=0; i<NUM_CHANS; i++)
 	{
-		MemorySystem *channel = new MemorySystem(i, megsOfMemory/NUM_CHANS, (*csvOut), dramsim_log);
+		MemorySystem *channel = new MemorySystem(i, megsOfMemory/NUM_CHANS, (*statsOut), dramsim_log);
 		channels.push_back(channel);
 	}
+	if (LIVE_STATS_SHM != "")
+	{
+		liveStats = new LiveStatsPublisher(LIVE_STATS_SHM, NUM_CHANS);
+	}
+	if (FUNCTIONAL_STORE != "")
+	{
+#ifdef NO_STORAGE
+		PRINT("WARNING: FUNCTIONAL_STORE has no effect in a build with NO_STORAGE");
+#else
+		backingStore = new BackingStore(FUNCTIONAL_STORE, NUM_CHANS);
+		for (size_t i=0; i<NUM_CHANS; i++)
+		{
+			channels[i]->setBackingStore(backingStore);
+		}
+#endif
+	}
 }
 /* Initialize the ClockDomainCrosser to use the CPU speed 
 	If cpuClkFreqHz == 0, then assume a 1:1 ratio (like for TraceBasedSim)
+
+	The ratio is exact: with tCK in femtoseconds, the memory clock is
+	1e15/tCK Hz, so there are 1e15 memory cycles for every tCK*cpuClkFreqHz
+	CPU cycles (rounding the memory clock to whole Hz would make the clocks
+	drift apart on long runs).
 	*/
 void MultiChannelMemorySystem::setCPUClockSpeed(uint64_t cpuClkFreqHz)
 {
-
-	uint64_t dramsimClkFreqHz = (uint64_t)(1.0/(tCK*1e-9));
-	clockDomainCrosser.clock1 = dramsimClkFreqHz; 
-	clockDomainCrosser.clock2 = (cpuClkFreqHz == 0) ? dramsimClkFreqHz : cpuClkFreqHz; 
+	if (cpuClkFreqHz == 0)
+	{
+		clockDomainCrosser.setClocks(1, 1);
+		return;
+	}
+	uint64_t tCKfs = (uint64_t)llround(tCK * 1e6);
+	if (cpuClkFreqHz > (uint64_t)-1 / tCKfs)
+	{
+		ERROR("CPU clock frequency "<<cpuClkFreqHz<<"Hz is too high");
+		abort();
+	}
+	clockDomainCrosser.setClocks(1000000000000000ULL, tCKfs * cpuClkFreqHz);
 }
 
 bool fileExists(string &path)
@@ -159,11 +199,12 @@ string FilenameWithNumberSuffix(const string &filename, const string &extension,
  * 	- The .log file if LOG_OUTPUT is set
  * 	- the .vis file where csv data for each epoch will go
  * 	- the .tmp file if verification output is enabled
+ * 	- a .cmdtrace file per channel if COMMAND_TRACE is set
  * The results directory is setup to be in PWD/TRACEFILENAME.[SIM_DESC]/DRAM_PARTNAME/PARAMS.vis
  * The environment variable SIM_DESC is also appended to output files/directories
  *
  * TODO: verification info needs to be generated per channel so it has to be
- * moved back to MemorySystem
+ * moved back to MemorySystem (COMMAND_TRACE already is per channel)
  **/
 void MultiChannelMemorySystem::InitOutputFiles(string traceFilename)
 {
@@ -272,7 +313,7 @@ void MultiChannelMemorySystem::InitOutputFiles(string traceFilename)
 		filename = out.str();
 
 
-		filename = FilenameWithNumberSuffix(filename, ".vis"); 
+		filename = FilenameWithNumberSuffix(filename, visFileFormat == BinaryVisFile ? ".visbin" : ".vis"); 
 		path.append(filename);
 		cerr << "writing vis file to " <<path<<endl;
 
@@ -309,6 +350,50 @@ void MultiChannelMemorySystem::InitOutputFiles(string traceFilename)
 	}
 #endif
 
+	if (ASYNC_LOG)
+	{
+#ifdef LOG_OUTPUT
+		asyncLog = new AsyncLogBuffer(dramsim_log.rdbuf());
+		savedLogBuffer = static_cast<ostream &>(dramsim_log).rdbuf(asyncLog);
+#else
+		asyncLog = AsyncLogBuffer::attachCout();
+#endif
+	}
+
+	if (commandTraceFormat != NoCommandTrace)
+	{
+		for (size_t i=0; i<NUM_CHANS; i++)
+		{
+			stringstream commandTraceFilename;
+			commandTraceFilename << "dramsim";
+			if (sim_description != NULL)
+			{
+				commandTraceFilename << "." << sim_description_str;
+			}
+			commandTraceFilename << ".ch" << i;
+			string filename = FilenameWithNumberSuffix(commandTraceFilename.str(), CommandTrace::extension(commandTraceFormat));
+			cerr << "writing command trace to " <<filename<<endl;
+			channels[i]->setCommandTrace(new CommandTrace(filename, i, commandTraceFormat));
+		}
+	}
+
+	if (BUS_LOG)
+	{
+		string busLogFilename("dramsim");
+		if (sim_description != NULL)
+		{
+			busLogFilename += "."+sim_description_str; 
+		}
+		busLogFilename = FilenameWithNumberSuffix(busLogFilename, ".buslog"); 
+		cerr << "writing bus log to " <<busLogFilename<<endl;
+
+		busLog = new BusLog(busLogFilename);
+		for (size_t i=0; i<NUM_CHANS; i++)
+		{
+			channels[i]->setBusLog(busLog);
+		}
+	}
+
 }
 
 
@@ -355,6 +440,28 @@ MultiChannelMemorySystem::~MultiChannelMemorySystem()
 		delete channels[i];
 	}
 	channels.clear(); 
+	delete statsOut;
+	delete liveStats;
+	delete busLog;
+	// the file holds the final contents of the memory once it is unmapped
+	delete backingStore;
+	delete completionQueue;
+	for (size_t i=0; i<submissionQueues.size(); i++)
+	{
+		delete submissionQueues[i];
+	}
+
+	// write out the buffered output before the log is closed
+	if (asyncLog != NULL)
+	{
+#ifdef LOG_OUTPUT
+		static_cast<ostream &>(dramsim_log).rdbuf(savedLogBuffer);
+		delete asyncLog;
+#else
+		// the last instance writes out the buffer on cout
+		AsyncLogBuffer::detachCout();
+#endif
+	}
 
 // flush our streams and close them up
 #ifdef LOG_OUTPUT
@@ -367,28 +474,257 @@ MultiChannelMemorySystem::~MultiChannelMemorySystem()
 		visDataOut.close();
 	}
 }
+//one CPU cycle; the memory cycles it covers are run directly rather than through the crosser's callback
 void MultiChannelMemorySystem::update()
 {
-	clockDomainCrosser.update(); 
+	uint64_t memoryCycles = clockDomainCrosser.advance(1);
+	for (uint64_t i=0; i<memoryCycles; i++)
+	{
+		actual_update();
+	}
+}
+
+/*
+	Advances the memory system by a number of CPU cycles in one call. This
+	is the same as calling update() that many times, but the clock crossing
+	is worked out once and the memory cycles are run directly.
+*/
+void MultiChannelMemorySystem::update(uint64_t cycles)
+{
+	uint64_t memoryCycles = clockDomainCrosser.advance(cycles);
+	for (uint64_t i=0; i<memoryCycles; i++)
+	{
+		actual_update();
+	}
+}
+
+/*
+	Advances the memory system until the next read or write callback fires,
+	for at most maxCycles CPU cycles, and returns the number of CPU cycles
+	advanced. A co-simulator that has no new requests to send can use this
+	to jump its own clock ahead to the next completion. It returns 0 right
+	away if no request is in flight, since then no callback can fire until a
+	new request is added. 
+*/
+uint64_t MultiChannelMemorySystem::runUntilNextEvent(uint64_t maxCycles)
+{
+	uint64_t completed = completedTransactions();
+	uint64_t cycles = 0;
+	while (cycles < maxCycles && !isIdle())
+	{
+		uint64_t memoryCycles = clockDomainCrosser.advance(1);
+		for (uint64_t i=0; i<memoryCycles; i++)
+		{
+			actual_update();
+		}
+		cycles++;
+		if (completedTransactions() != completed)
+		{
+			break;
+		}
+	}
+	return cycles;
+}
+
+/*
+	Instead of (or as well as) the read and write callbacks, completions can
+	be queued for the caller to drain in batches with drainCompletions(),
+	possibly from another thread than the one calling update(). entries
+	should cover the completions expected between two drains; see
+	CompletionQueue.h. 
+*/
+void MultiChannelMemorySystem::enableCompletionQueue(unsigned entries)
+{
+	if (completionQueue != NULL)
+	{
+		ERROR("The completion queue is already enabled");
+		abort();
+	}
+	completionQueue = new CompletionQueue(entries);
+	for (size_t i=0; i<NUM_CHANS; i++)
+	{
+		channels[i]->memoryController->completionQueue = completionQueue;
+	}
+}
+
+/*
+	Checkpoints: saveCheckpoint() writes everything that changes while
+	simulating (queued requests and commands, bank and rank states, refresh
+	and power state, energy and the statistics of the current epoch, and
+	the clock crossing) to a binary file. restoreCheckpoint() loads it into
+	a memory system that has nothing in flight, typically a fresh one, after
+	which the simulation continues exactly as it would have from the saved
+	one. The configuration may differ in anything that does not change the
+	shape of the state (the scheduling policy, timings, the power model), so
+	one warmed up checkpoint can be reused for a sweep; a checkpoint of a
+	different geometry is rejected. The row buffer policy may only differ
+	if no commands were queued and no rows were open when the checkpoint
+	was saved, since queued commands and open rows depend on it; otherwise
+	the checkpoint is rejected as well. Completions that were not drained
+	yet and requests still in the submission queues are not part of the
+	checkpoint, and neither is the data kept by a build without NO_STORAGE,
+	so such a build refuses to save or restore checkpoints.
+*/
+void MultiChannelMemorySystem::saveCheckpoint(const string &filename)
+{
+	Checkpoint cp(filename, true);
+	checkpoint(cp);
+}
+
+void MultiChannelMemorySystem::restoreCheckpoint(const string &filename)
+{
+	if (!isIdle())
+	{
+		ERROR("A checkpoint can only be restored into an idle memory system");
+		abort();
+	}
+	uint64_t cycleBefore = currentClockCycle;
+	Checkpoint cp(filename, false);
+	checkpoint(cp);
+	//actual_update() only opens the output files at cycle 0
+	if (cycleBefore == 0 && currentClockCycle != 0)
+	{
+		InitOutputFiles(traceFilename);
+	}
+}
+
+/*
+	Switches every channel to the approximate analytical model (see
+	FastMemoryModel.h) or back to the detailed one, at any time; the
+	initial model is set with MEMORY_MODEL in the system ini file. Requests
+	in flight finish in the model they were sent to. A CPU simulator can,
+	e.g., fast forward through initialization in fast mode and switch to
+	the detailed model for the region of interest.
+*/
+void MultiChannelMemorySystem::setFastMode(bool fast)
+{
+	for (size_t i=0; i<NUM_CHANS; i++)
+	{
+		channels[i]->setFastMode(fast);
+	}
+}
+
+void MultiChannelMemorySystem::checkpoint(Checkpoint &cp)
+{
+#ifndef NO_STORAGE
+	ERROR("Checkpoints don't include the stored data; build with NO_STORAGE to use them");
+	abort();
+#endif
+	cp.checkSize(NUM_CHANS);
+	cp.checkSize(NUM_RANKS);
+	cp.checkSize(NUM_BANKS);
+	cp.io(currentClockCycle);
+	cp.io(clockDomainCrosser.clock1);
+	cp.io(clockDomainCrosser.clock2);
+	cp.io(clockDomainCrosser.counter1);
+	cp.io(clockDomainCrosser.counter2);
+	for (size_t i=0; i<NUM_CHANS; i++)
+	{
+		cp.section("CHAN");
+		channels[i]->checkpoint(cp);
+	}
+	cp.section("END.");
+}
+
+/*
+	For CPU models that generate requests from several threads: after
+	enableSubmissionQueues(), submitTransaction() may be called from any
+	number of threads at once, also while update() runs, without a lock.
+	Each channel gets a queue of entries requests in front of its
+	transaction queue, which is drained at the start of every memory cycle.
+	submitTransaction() returns false when the queue of the request's
+	channel is full; the thread should then try again later. Everything
+	else, including addTransaction(), still has to be called from the thread
+	that calls update(). 
+*/
+void MultiChannelMemorySystem::enableSubmissionQueues(unsigned entries)
+{
+	if (!submissionQueues.empty())
+	{
+		ERROR("The submission queues are already enabled");
+		abort();
+	}
+	for (size_t i=0; i<NUM_CHANS; i++)
+	{
+		submissionQueues.push_back(new SubmissionQueue(entries));
+	}
+}
+
+bool MultiChannelMemorySystem::submitTransaction(bool isWrite, uint64_t addr)
+{
+	return submitTransaction(isWrite, addr, 0);
+}
+
+bool MultiChannelMemorySystem::submitTransaction(bool isWrite, uint64_t addr, uint64_t tag)
+{
+	if (submissionQueues.empty())
+	{
+		ERROR("submitTransaction() needs enableSubmissionQueues() first");
+		abort();
+	}
+	unsigned channelNumber = findChannelNumber(addr);
+	return submissionQueues[channelNumber]->push(isWrite, addr, tag);
+}
+
+//copies up to max completions to out, oldest first, and returns how many
+unsigned MultiChannelMemorySystem::drainCompletions(Completion *out, unsigned max)
+{
+	if (completionQueue == NULL)
+	{
+		return 0;
+	}
+	return completionQueue->pop(out, max);
+}
+
+uint64_t MultiChannelMemorySystem::completedTransactions()
+{
+	uint64_t completed = 0;
+	for (size_t i=0; i<NUM_CHANS; i++)
+	{
+		completed += channels[i]->memoryController->completedTransactions;
+		if (channels[i]->fastModel != NULL)
+		{
+			completed += channels[i]->fastModel->completedTransactions;
+		}
+	}
+	return completed;
 }
 void MultiChannelMemorySystem::actual_update() 
 {
 	if (currentClockCycle == 0)
 	{
 		InitOutputFiles(traceFilename);
-		DEBUG("DRAMSim2 Clock Frequency ="<<clockDomainCrosser.clock1<<"Hz, CPU Clock Frequency="<<clockDomainCrosser.clock2<<"Hz"); 
+		DEBUG("DRAMSim2 Clock Frequency ="<<1000.0/tCK<<"MHz, "<<clockDomainCrosser.clock1<<" memory cycles every "<<clockDomainCrosser.clock2<<" CPU cycles"); 
 	}
 
 	if (currentClockCycle % EPOCH_LENGTH == 0)
 	{
-		(*csvOut) << "ms" <<currentClockCycle * tCK * 1E-6; 
+		statsOut->set(timeColumn, currentClockCycle * tCK * 1E-6);
 		for (size_t i=0; i<NUM_CHANS; i++)
 		{
 			channels[i]->printStats(false); 
 		}
-		csvOut->finalize();
+		statsOut->writeRow();
+		publishLiveStats();
+#ifdef PROFILE_BUILD
+		SimProfiler::report(dramsim_log, currentClockCycle, false);
+#endif
 	}
 	
+	//requests submitted by other threads since the last cycle
+	for (size_t i=0; i<submissionQueues.size(); i++)
+	{
+		MemorySystem *channel = channels[i];
+		bool isWrite;
+		uint64_t addr, tag;
+		while (channel->WillAcceptTransaction() && submissionQueues[i]->pop(isWrite, addr, tag))
+		{
+			Transaction *trans = new Transaction(isWrite ? DATA_WRITE : DATA_READ, addr, NULL);
+			trans->tag = tag;
+			channel->addTransaction(trans);
+		}
+	}
+
 	for (size_t i=0; i<NUM_CHANS; i++)
 	{
 		channels[i]->update(); 
@@ -442,9 +778,80 @@ bool MultiChannelMemorySystem::addTransaction(Transaction *trans)
 }
 
 bool MultiChannelMemorySystem::addTransaction(bool isWrite, uint64_t addr)
+{
+	return addTransaction(isWrite, addr, 0);
+}
+
+//tag is not interpreted, it comes back in the Completion of the request
+bool MultiChannelMemorySystem::addTransaction(bool isWrite, uint64_t addr, uint64_t tag)
 {
 	unsigned channelNumber = findChannelNumber(addr); 
-	return channels[channelNumber]->addTransaction(isWrite, addr); 
+	return channels[channelNumber]->addTransaction(isWrite, addr, tag); 
+}
+
+/*
+	Batch version of addTransaction(isWrite, addr) for simulators that
+	produce requests in bursts: count requests (isWrite[i], addrs[i]) are
+	decoded, routed and enqueued in one call. The decoded address is kept in
+	the transaction so the memory controller does not map it again. 
+
+	Unlike addTransaction(isWrite, addr), a request whose channel has a full
+	transaction queue is not buffered but rejected, so there is no need to
+	call willAcceptTransaction() first. If accepted is not NULL, accepted[i]
+	is set to whether request i was taken; rejected requests should be
+	offered again after the next update(). A full queue stays full for the
+	rest of the batch, so the requests to each channel are accepted in order.
+	Returns the number of accepted requests. If tags is not NULL, tags[i] is
+	the tag of request i, as for addTransaction(isWrite, addr, tag).
+*/
+unsigned MultiChannelMemorySystem::addTransactions(const bool *isWrite, const uint64_t *addrs, unsigned count, bool *accepted)
+{
+	return addTransactions(isWrite, addrs, NULL, count, accepted);
+}
+
+unsigned MultiChannelMemorySystem::addTransactions(const bool *isWrite, const uint64_t *addrs, const uint64_t *tags, unsigned count, bool *accepted)
+{
+	if (!isPowerOfTwo(NUM_CHANS))
+	{
+		ERROR("We can only support power of two # of channels.");
+		abort(); 
+	}
+
+	unsigned numAccepted = 0;
+	for (unsigned i=0; i<count; i++)
+	{
+		unsigned chan, rank, bank, row, col;
+		addressMapping(addrs[i], chan, rank, bank, row, col);
+		if (chan >= NUM_CHANS)
+		{
+			ERROR("Got channel index "<<chan<<" but only "<<NUM_CHANS<<" exist"); 
+			abort();
+		}
+
+		MemorySystem *channel = channels[chan];
+		bool ok = channel->WillAcceptTransaction();
+		if (ok)
+		{
+			Transaction *trans = new Transaction(isWrite[i] ? DATA_WRITE : DATA_READ, addrs[i], NULL);
+			trans->channel = chan;
+			trans->rank = rank;
+			trans->bank = bank;
+			trans->row = row;
+			trans->column = col;
+			trans->addressMapped = true;
+			if (tags != NULL)
+			{
+				trans->tag = tags[i];
+			}
+			channel->addTransaction(trans);
+			numAccepted++;
+		}
+		if (accepted != NULL)
+		{
+			accepted[i] = ok;
+		}
+	}
+	return numAccepted;
 }
 
 /*
@@ -478,15 +885,107 @@ bool MultiChannelMemorySystem::willAcceptTransaction()
 
 void MultiChannelMemorySystem::printStats(bool finalStats) {
 
-	(*csvOut) << "ms" <<currentClockCycle * tCK * 1E-6; 
+	statsOut->set(timeColumn, currentClockCycle * tCK * 1E-6);
 	for (size_t i=0; i<NUM_CHANS; i++)
 	{
 		PRINT("==== Channel ["<<i<<"] ====");
 		channels[i]->printStats(finalStats); 
 		PRINT("//// Channel ["<<i<<"] ////");
 	}
-	csvOut->finalize();
+	statsOut->writeRow();
+	publishLiveStats();
+#ifdef PROFILE_BUILD
+	SimProfiler::report(dramsim_log, currentClockCycle, finalStats);
+#endif
 }
+
+void MultiChannelMemorySystem::publishLiveStats()
+{
+	if (liveStats == NULL || currentClockCycle == 0)
+	{
+		return;
+	}
+	for (size_t i=0; i<NUM_CHANS; i++)
+	{
+		liveStats->setChannel(i, channels[i]->memoryController->getEpochSummary());
+	}
+	liveStats->publish(currentClockCycle, currentClockCycle * tCK * 1E-6);
+}
+/*
+ * Merge the read latency histograms (in cycles) of all the channels into
+ * histogram, which must have been built with HISTOGRAM_PRECISION
+ */
+void MultiChannelMemorySystem::getLatencyHistogram(LatencyHistogram &histogram)
+{
+	for (size_t i=0; i<NUM_CHANS; i++)
+	{
+		histogram.merge(channels[i]->memoryController->getLatencyHistogram());
+		if (channels[i]->fastModel != NULL)
+		{
+			histogram.merge(channels[i]->fastModel->latencies);
+		}
+	}
+}
+
+void MultiChannelMemorySystem::resetLatencyHistogram()
+{
+	for (size_t i=0; i<NUM_CHANS; i++)
+	{
+		channels[i]->memoryController->resetLatencyHistogram();
+		if (channels[i]->fastModel != NULL)
+		{
+			channels[i]->fastModel->latencies.reset();
+		}
+	}
+}
+
+void MultiChannelMemorySystem::resetStats()
+{
+	for (size_t i=0; i<NUM_CHANS; i++)
+	{
+		channels[i]->memoryController->resetStats();
+		if (channels[i]->fastModel != NULL)
+		{
+			channels[i]->fastModel->resetStats();
+		}
+	}
+}
+
+bool MultiChannelMemorySystem::isIdle()
+{
+	for (size_t i=0; i<NUM_CHANS; i++)
+	{
+		if (!channels[i]->isIdle() || (!submissionQueues.empty() && !submissionQueues[i]->empty()))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * Sampled simulation support: these let a driver skip through the parts of a
+ * workload it does not want to simulate in detail. fastForward() jumps the
+ * memory clock ahead by a number of memory cycles while only keeping track of
+ * open rows and refreshes, and functionalAccess() applies the row buffer
+ * effect of a request without timing it. The memory system has to be idle
+ * (i.e. all requests completed) before fast forwarding.
+ */
+void MultiChannelMemorySystem::fastForward(uint64_t cycles)
+{
+	for (size_t i=0; i<NUM_CHANS; i++)
+	{
+		channels[i]->fastForward(cycles);
+	}
+	currentClockCycle += cycles;
+}
+
+void MultiChannelMemorySystem::functionalAccess(uint64_t addr)
+{
+	unsigned channelNumber = findChannelNumber(addr);
+	channels[channelNumber]->memoryController->functionalAccess(addr);
+}
+
 void MultiChannelMemorySystem::RegisterCallbacks( 
 		TransactionCompleteCB *readDone,
 		TransactionCompleteCB *writeDone,
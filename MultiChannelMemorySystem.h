@@ -27,13 +27,21 @@
 *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *********************************************************************************/
+#ifndef MULTICHANNELMEMORYSYSTEM_H
+#define MULTICHANNELMEMORYSYSTEM_H
+
 #include "SimulatorObject.h"
 #include "Transaction.h"
 #include "SystemConfiguration.h"
 #include "MemorySystem.h"
 #include "IniReader.h"
 #include "ClockDomain.h"
-#include "CSVWriter.h"
+#include "StatsWriter.h"
+#include "LiveStats.h"
+#include "AsyncLogBuffer.h"
+#include "BusLog.h"
+#include "BackingStore.h"
+#include "SubmissionQueue.h"
 
 
 namespace DRAMSim {
@@ -48,10 +56,29 @@ class MultiChannelMemorySystem : public SimulatorObject
 			bool addTransaction(Transaction *trans);
 			bool addTransaction(const Transaction &trans);
 			bool addTransaction(bool isWrite, uint64_t addr);
+			bool addTransaction(bool isWrite, uint64_t addr, uint64_t tag);
+			unsigned addTransactions(const bool *isWrite, const uint64_t *addrs, unsigned count, bool *accepted=NULL);
+			unsigned addTransactions(const bool *isWrite, const uint64_t *addrs, const uint64_t *tags, unsigned count, bool *accepted=NULL);
 			bool willAcceptTransaction(); 
 			bool willAcceptTransaction(uint64_t addr); 
 			void update();
+			void update(uint64_t cycles);
+			uint64_t runUntilNextEvent(uint64_t maxCycles);
+			void enableCompletionQueue(unsigned entries);
+			unsigned drainCompletions(Completion *out, unsigned max);
+			void enableSubmissionQueues(unsigned entries);
+			bool submitTransaction(bool isWrite, uint64_t addr);
+			bool submitTransaction(bool isWrite, uint64_t addr, uint64_t tag);
+			void saveCheckpoint(const string &filename);
+			void restoreCheckpoint(const string &filename);
+			void setFastMode(bool fast);
 			void printStats(bool finalStats=false);
+			void getLatencyHistogram(LatencyHistogram &histogram);
+			void resetLatencyHistogram();
+			void resetStats();
+			bool isIdle();
+			void fastForward(uint64_t cycles);
+			void functionalAccess(uint64_t addr);
 			ostream &getLogFile();
 			void RegisterCallbacks( 
 				TransactionCompleteCB *readDone,
@@ -71,6 +98,8 @@ class MultiChannelMemorySystem : public SimulatorObject
 
 	private:
 		unsigned findChannelNumber(uint64_t addr);
+		uint64_t completedTransactions();
+		void checkpoint(Checkpoint &cp);
 		void actual_update(); 
 		vector<MemorySystem*> channels; 
 		unsigned megsOfMemory; 
@@ -82,8 +111,19 @@ class MultiChannelMemorySystem : public SimulatorObject
 		ClockDomain::ClockDomainCrosser clockDomainCrosser; 
 		static void mkdirIfNotExist(string path);
 		static bool fileExists(string path); 
-		CSVWriter *csvOut; 
+		StatsWriter *statsOut;
+		unsigned timeColumn;
+		LiveStatsPublisher *liveStats;
+		void publishLiveStats();
+		AsyncLogBuffer *asyncLog; // shared by all instances on cout, see AsyncLogBuffer::attachCout()
+		streambuf *savedLogBuffer; // the stream buffer asyncLog replaced (only with LOG_OUTPUT)
+		BusLog *busLog;
+		BackingStore *backingStore;
+		CompletionQueue *completionQueue;
+		vector<SubmissionQueue *> submissionQueues; // only after enableSubmissionQueues()
 
 
 	};
 }
+
+#endif
@@ -0,0 +1,155 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+//PowerModel.cpp
+//
+//Class file for the interface of the DRAM power models
+//
+
+#include <stdlib.h>
+
+#include "PowerModel.h"
+#include "LegacyPowerModel.h"
+#include "DetailedPowerModel.h"
+#include "Checkpoint.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+const char *PowerModel::rankStateNames[NUM_RANK_STATES] = {"ACT_STBY", "PRE_STBY", "ACT_PDN", "PRE_PDN", "SREF"};
+
+PowerModel::PowerModel(unsigned numRanks_) :
+	numRanks(numRanks_),
+	energy(numRanks_),
+	state(numRanks_, PrechargeStandby),
+	openBanks(numRanks_, 0),
+	backgroundPerCycle(numRanks_, 0.0),
+	stateSince(numRanks_, 0),
+	residency(numRanks_*NUM_RANK_STATES, 0)
+{
+}
+
+PowerModel::~PowerModel()
+{
+}
+
+PowerModel *PowerModel::create(unsigned numRanks)
+{
+	PowerModel *model;
+	if (powerModelType == DetailedPower)
+	{
+		model = new DetailedPowerModel(numRanks);
+	}
+	else
+	{
+		model = new LegacyPowerModel(numRanks);
+	}
+	// the virtual backgroundEnergy() can't be called from our constructor
+	model->reset(0);
+	return model;
+}
+
+void PowerModel::setRankState(unsigned rank, RankState newState, unsigned newOpenBanks, uint64_t cycle)
+{
+	if (newState == state[rank] && newOpenBanks == openBanks[rank])
+	{
+		return;
+	}
+	accumulate(rank, cycle);
+	state[rank] = newState;
+	openBanks[rank] = newOpenBanks;
+	backgroundPerCycle[rank] = backgroundEnergy(newState, newOpenBanks);
+}
+
+void PowerModel::skip(uint64_t cycle, uint64_t cycles)
+{
+	for (size_t r=0; r<numRanks; r++)
+	{
+		accumulate(r, cycle);
+		stateSince[r] = cycle + cycles;
+	}
+}
+
+const PowerModel::Energy &PowerModel::getEnergy(unsigned rank, uint64_t cycle)
+{
+	accumulate(rank, cycle);
+	return energy[rank];
+}
+
+uint64_t PowerModel::getResidency(unsigned rank, RankState s) const
+{
+	return residency[rank*NUM_RANK_STATES + s];
+}
+
+void PowerModel::reset(uint64_t cycle)
+{
+	for (size_t r=0; r<numRanks; r++)
+	{
+		energy[r] = Energy();
+		stateSince[r] = cycle;
+		backgroundPerCycle[r] = backgroundEnergy(state[r], openBanks[r]);
+		for (size_t s=0; s<NUM_RANK_STATES; s++)
+		{
+			residency[r*NUM_RANK_STATES + s] = 0;
+		}
+	}
+}
+
+void PowerModel::accumulate(unsigned rank, uint64_t cycle)
+{
+	if (cycle <= stateSince[rank])
+	{
+		return;
+	}
+	uint64_t cycles = cycle - stateSince[rank];
+	energy[rank].background += backgroundPerCycle[rank] * cycles;
+	residency[rank*NUM_RANK_STATES + state[rank]] += cycles;
+	stateSince[rank] = cycle;
+}
+
+//the accumulated energy and the state of every rank (the model itself is
+//taken from the configuration, so it can differ from the saved one, and the
+//background energy per cycle is recomputed with it)
+void PowerModel::checkpoint(Checkpoint &cp)
+{
+	cp.checkSize(numRanks);
+	cp.io(energy);
+	cp.io(state);
+	cp.io(openBanks);
+	cp.io(stateSince);
+	cp.io(residency);
+	for (size_t r=0; r<numRanks; r++)
+	{
+		backgroundPerCycle[r] = backgroundEnergy(state[r], openBanks[r]);
+	}
+}
@@ -0,0 +1,153 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+#ifndef POWERMODEL_H
+#define POWERMODEL_H
+
+//PowerModel.h
+//
+//Header file for the interface of the DRAM power models
+//
+
+#include <vector>
+#include <stdint.h>
+
+#include "BusPacket.h"
+#include "SystemConfiguration.h"
+
+using std::vector;
+
+/* device currents (mA) and voltages from the device ini file, see IniReader.cpp */
+extern unsigned IDD0;
+extern unsigned IDD1;
+extern unsigned IDD2P;
+extern unsigned IDD2Q;
+extern unsigned IDD2N;
+extern unsigned IDD3Pf;
+extern unsigned IDD3Ps;
+extern unsigned IDD3N;
+extern unsigned IDD4W;
+extern unsigned IDD4R;
+extern unsigned IDD5;
+extern unsigned IDD6;
+extern unsigned IDD6L;
+extern unsigned IDD7;
+extern float Vdd;
+
+/* the VPP (wordline pump) currents of DDR4 devices, 0 if not given */
+extern float IPP0;
+extern float IPP2N;
+extern float IPP2P;
+extern float IPP3N;
+extern float IPP3P;
+extern float IPP4R;
+extern float IPP4W;
+extern float IPP5;
+extern float IPP6;
+extern float Vpp;
+
+namespace DRAMSim
+{
+class Checkpoint;
+
+/*
+ * Accounts the energy of the ranks of one channel (POWER_MODEL in
+ * system.ini selects the implementation, see create()). The memory
+ * controller calls command() for every command it issues and
+ * setRankState() whenever the power state of a rank or its number of open
+ * banks changes, so the background energy is accounted once per state
+ * change (as state energy * cycles spent in it) rather than every cycle.
+ *
+ * All energies are in pJ for the whole rank (all NUM_DEVICES devices).
+ */
+class PowerModel
+{
+public:
+	enum RankState
+	{
+		ActiveStandby, // at least one bank open (or refreshing)
+		PrechargeStandby,
+		ActivePowerDown,
+		PrechargePowerDown,
+		SelfRefresh,
+		NUM_RANK_STATES
+	};
+	static const char *rankStateNames[NUM_RANK_STATES];
+
+	struct Energy
+	{
+		double background;
+		double actpre;
+		double burst;
+		double refresh;
+		double total() const { return background + actpre + burst + refresh; }
+	};
+
+	PowerModel(unsigned numRanks_);
+	virtual ~PowerModel();
+	static PowerModel *create(unsigned numRanks);
+
+	// account the energy of a command issued to rank
+	virtual void command(unsigned rank, BusPacketType type) = 0;
+
+	// the rank is in state with openBanks banks open from cycle on
+	void setRankState(unsigned rank, RankState state, unsigned openBanks, uint64_t cycle);
+	// no energy is accounted for cycles skipped by fast forward
+	void skip(uint64_t cycle, uint64_t cycles);
+	// energy of rank since the last reset(), up to cycle
+	const Energy &getEnergy(unsigned rank, uint64_t cycle);
+	// cycles rank spent in state, up to the last getEnergy()
+	uint64_t getResidency(unsigned rank, RankState state) const;
+	void reset(uint64_t cycle);
+	void checkpoint(Checkpoint &cp);
+
+protected:
+	// background energy of a rank per cycle
+	virtual double backgroundEnergy(RankState state, unsigned openBanks) const = 0;
+
+	unsigned numRanks;
+	vector<Energy> energy;
+
+private:
+	void accumulate(unsigned rank, uint64_t cycle);
+
+	vector<RankState> state;
+	vector<unsigned> openBanks;
+	vector<double> backgroundPerCycle; // backgroundEnergy() of the current state
+	vector<uint64_t> stateSince;
+	vector<uint64_t> residency; // per rank and state
+};
+}
+
+#endif
+
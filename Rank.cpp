@@ -33,6 +33,8 @@
 
 #include "Rank.h"
 #include "MemoryController.h"
+#include "SimProfiler.h"
+#include "Checkpoint.h"
 
 using namespace std;
 using namespace DRAMSim;
@@ -49,6 +51,8 @@ Rank::Rank(ostream &dramsim_log_) :
 {
 
 	memoryController = NULL;
+	busLog = NULL;
+	busLogChannel = 0;
 	outgoingDataPacket = NULL;
 	dataCyclesLeft = 0;
 	currentClockCycle = 0;
@@ -64,6 +68,15 @@ void Rank::setId(int id)
 	this->id = id;
 }
 
+//keep the data of the banks in their part of store (only without NO_STORAGE)
+void Rank::setBackingStore(BackingStore *store, unsigned channel)
+{
+	for (size_t i=0; i<NUM_BANKS; i++)
+	{
+		banks[i].setBackingStore(store->bankData(channel, id, i));
+	}
+}
+
 // attachMemoryController() must be called before any other Rank functions
 // are called
 void Rank::attachMemoryController(MemoryController *memoryController)
@@ -86,6 +99,10 @@ void Rank::receiveFromBus(BusPacket *packet)
 		PRINTN(" -- R" << this->id << " Receiving On Bus    : ");
 		packet->print();
 	}
+	if (busLog != NULL)
+	{
+		busLog->record(BusLog::RankReceive, busLogChannel, currentClockCycle, packet);
+	}
 	if (VERIFICATION_OUTPUT)
 	{
 		packet->print(currentClockCycle,false);
@@ -298,6 +315,7 @@ int Rank::getId() const
 
 void Rank::update()
 {
+	PROFILE_SCOPE(RankUpdate)
 
 	// An outgoing packet is one that is currently sending on the bus
 	// do the book keeping for the packet's time left on the bus
@@ -337,7 +355,37 @@ void Rank::update()
 			outgoingDataPacket->print();
 			PRINT("");
 		}
+		if (busLog != NULL)
+		{
+			busLog->record(BusLog::RankDataIssue, busLogChannel, currentClockCycle, outgoingDataPacket);
+		}
+
+	}
+}
+
+//true if no data is on its way back to the controller
+bool Rank::isIdle() const
+{
+	return outgoingDataPacket == NULL && readReturnPacket.empty();
+}
 
+//skip ahead without simulating the cycles in between; only open rows survive
+void Rank::fastForward(uint64_t cycles)
+{
+	currentClockCycle += cycles;
+	isPowerDown = false;
+	for (size_t i=0;i<NUM_BANKS;i++)
+	{
+		if (bankStates[i].currentBankState != RowActive)
+		{
+			bankStates[i].currentBankState = Idle;
+		}
+		bankStates[i].stateChangeCountdown = 0;
+		bankStates[i].nextRead = currentClockCycle;
+		bankStates[i].nextWrite = currentClockCycle;
+		bankStates[i].nextActivate = currentClockCycle;
+		bankStates[i].nextPrecharge = currentClockCycle;
+		bankStates[i].nextPowerUp = currentClockCycle;
 	}
 }
 
@@ -383,3 +431,24 @@ void Rank::powerUp()
 		bankStates[i].currentBankState = Idle;
 	}
 }
+
+//the bank states and the data on its way back (the banks themselves hold no
+//state without storage)
+void Rank::checkpoint(Checkpoint &cp)
+{
+	cp.io(currentClockCycle);
+	cp.io(incomingWriteBank);
+	cp.io(incomingWriteRow);
+	cp.io(incomingWriteColumn);
+	cp.io(isPowerDown);
+	cp.io(outgoingDataPacket, dramsim_log);
+	cp.io(dataCyclesLeft);
+	cp.io(refreshWaiting);
+	cp.io(readReturnPacket, dramsim_log);
+	cp.io(readReturnCountdown);
+	cp.checkSize(bankStates.size());
+	for (size_t i=0; i<bankStates.size(); i++)
+	{
+		bankStates[i].checkpoint(cp);
+	}
+}
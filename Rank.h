@@ -39,6 +39,8 @@
 #include "SystemConfiguration.h"
 #include "Bank.h"
 #include "BankState.h"
+#include "BusLog.h"
+#include "BackingStore.h"
 
 using namespace std;
 using namespace DRAMSim;
@@ -46,6 +48,7 @@ using namespace DRAMSim;
 namespace DRAMSim
 {
 class MemoryController; //forward declaration
+class Checkpoint;
 class Rank : public SimulatorObject
 {
 private:
@@ -67,9 +70,15 @@ public:
 	void update();
 	void powerUp();
 	void powerDown();
+	bool isIdle() const;
+	void fastForward(uint64_t cycles);
+	void checkpoint(Checkpoint &cp);
+	void setBackingStore(BackingStore *store, unsigned channel);
 
 	//fields
 	MemoryController *memoryController;
+	BusLog *busLog; // only with BUS_LOG
+	unsigned busLogChannel;
 	BusPacket *outgoingDataPacket;
 	unsigned dataCyclesLeft;
 	bool refreshWaiting;
@@ -0,0 +1,127 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+//SimProfiler.cpp
+//
+//Class file for the simulator's self-profiling
+//
+
+#include "SimProfiler.h"
+#include "PrintMacros.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+// only "make PROFILE=1" uses the profiler, so there's nothing to set up (or
+// time at startup) otherwise
+#ifdef PROFILE_BUILD
+
+uint64_t SimProfiler::calls[NUM_REGIONS];
+uint64_t SimProfiler::untilSample[NUM_REGIONS] = {1, 1, 1, 1, 1, 1};
+uint64_t SimProfiler::sampledCalls[NUM_REGIONS];
+uint64_t SimProfiler::sampledTime[NUM_REGIONS];
+uint64_t SimProfiler::transactions;
+uint64_t SimProfiler::startTime = SimProfiler::now();
+uint64_t SimProfiler::clockOverhead = SimProfiler::measureClockOverhead();
+uint64_t SimProfiler::randomState = 88172645463325252ULL;
+
+static const char *regionNames[] = {"Rank::update", "MemoryController::update", "CommandQueue::pop",
+	"addressMapping", "trace parsing", "stats output"};
+
+//the shortest time between two clock reads
+uint64_t SimProfiler::measureClockOverhead()
+{
+	uint64_t overhead = (uint64_t)-1;
+	for (size_t i=0; i<1000; i++)
+	{
+		uint64_t start = now();
+		uint64_t end = now();
+		if (end - start < overhead)
+		{
+			overhead = end - start;
+		}
+	}
+	return overhead;
+}
+
+/*
+ * Prints the simulation speed since the previous report (or since the
+ * start for the final stats) and where the host time went.
+ */
+void SimProfiler::report(ostream &dramsim_log, uint64_t currentClockCycle, bool finalStats)
+{
+	static uint64_t lastTime = startTime;
+	static uint64_t lastCycle = 0;
+	static uint64_t lastTransactions = 0;
+	static uint64_t lastCalls[NUM_REGIONS];
+	static uint64_t lastSampledCalls[NUM_REGIONS];
+	static uint64_t lastSampledTime[NUM_REGIONS];
+
+	uint64_t currentTime = now();
+	uint64_t elapsed = finalStats ? currentTime - startTime : currentTime - lastTime;
+	uint64_t cycles = finalStats ? currentClockCycle : currentClockCycle - lastCycle;
+	uint64_t newTransactions = finalStats ? transactions : transactions - lastTransactions;
+	double seconds = elapsed * 1E-9;
+
+	if (cycles > 0 && seconds > 0.0)
+	{
+		PRINT( " == Simulator Performance" << (finalStats ? " (whole run)" : "") << " : "
+				<< cycles / seconds << " DRAM cycles/s, " << newTransactions / seconds << " transactions/s ("
+				<< seconds << " s host time)");
+		for (size_t i=0; i<NUM_REGIONS; i++)
+		{
+			uint64_t regionCalls = finalStats ? calls[i] : calls[i] - lastCalls[i];
+			uint64_t regionSampledCalls = finalStats ? sampledCalls[i] : sampledCalls[i] - lastSampledCalls[i];
+			uint64_t regionSampledTime = finalStats ? sampledTime[i] : sampledTime[i] - lastSampledTime[i];
+			if (regionSampledCalls == 0)
+			{
+				continue;
+			}
+			double nsPerCall = (double)regionSampledTime / regionSampledCalls;
+			PRINT( "     -" << regionNames[i] << " : " << nsPerCall * regionCalls / elapsed * 100.0 << "% ("
+					<< regionCalls << " calls, " << nsPerCall << " ns/call)");
+		}
+	}
+
+	lastTime = currentTime;
+	lastCycle = currentClockCycle;
+	lastTransactions = transactions;
+	for (size_t i=0; i<NUM_REGIONS; i++)
+	{
+		lastCalls[i] = calls[i];
+		lastSampledCalls[i] = sampledCalls[i];
+		lastSampledTime[i] = sampledTime[i];
+	}
+}
+
+#endif // PROFILE_BUILD
@@ -0,0 +1,150 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+#ifndef SIMPROFILER_H
+#define SIMPROFILER_H
+
+//SimProfiler.h
+//
+//Header file for the simulator's self-profiling
+//
+
+#include <iostream>
+#include <stdint.h>
+#include <time.h>
+
+using std::ostream;
+
+namespace DRAMSim
+{
+/*
+ * Measures where DRAMSim itself spends host time. It is only compiled in
+ * with "make PROFILE=1" (PROFILE_BUILD); otherwise the macros below expand
+ * to nothing.
+ *
+ * PROFILE_SCOPE(region) at the top of a function counts every call and
+ * times about one call in SAMPLE_INTERVAL, which keeps the cost of reading
+ * the clock out of the numbers being measured. The gap between two sampled
+ * calls is random so that sampling doesn't lock onto periodic behavior
+ * (refreshes, trace timestamps, the other regions' samples). The total time
+ * of a region is extrapolated from its sampled calls, minus the cost of
+ * reading the clock. Regions nest (CommandQueuePop and AddressMapping are
+ * called from ControllerUpdate), so the times are inclusive and don't add
+ * up to 100%.
+ */
+class SimProfiler
+{
+public:
+	enum Region
+	{
+		RankUpdate,
+		ControllerUpdate,
+		CommandQueuePop,
+		AddressMapping,
+		TraceParsing,
+		StatsOutput,
+		NUM_REGIONS
+	};
+	static const uint64_t SAMPLE_INTERVAL = 16;
+
+	class Scope
+	{
+	public:
+		Scope(Region region_) : region(region_), start(0)
+		{
+			calls[region]++;
+			if (--untilSample[region] == 0)
+			{
+				untilSample[region] = nextSampleGap();
+				start = now();
+			}
+		}
+		~Scope()
+		{
+			if (start != 0)
+			{
+				uint64_t elapsed = now() - start;
+				sampledTime[region] += elapsed > clockOverhead ? elapsed - clockOverhead : 0;
+				sampledCalls[region]++;
+			}
+		}
+	private:
+		Region region;
+		uint64_t start;
+	};
+
+	static void countTransaction()
+	{
+		transactions++;
+	}
+	static void report(ostream &dramsim_log, uint64_t currentClockCycle, bool finalStats);
+
+	// host time in ns
+	static uint64_t now()
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	}
+
+private:
+	// uniform in [1, 2*SAMPLE_INTERVAL-1]
+	static uint64_t nextSampleGap()
+	{
+		randomState ^= randomState << 13;
+		randomState ^= randomState >> 7;
+		randomState ^= randomState << 17;
+		return 1 + randomState % (2*SAMPLE_INTERVAL-1);
+	}
+	static uint64_t measureClockOverhead();
+
+	static uint64_t calls[NUM_REGIONS];
+	static uint64_t untilSample[NUM_REGIONS];
+	static uint64_t sampledCalls[NUM_REGIONS];
+	static uint64_t sampledTime[NUM_REGIONS];
+	static uint64_t transactions;
+	static uint64_t startTime;
+	static uint64_t clockOverhead;
+	static uint64_t randomState;
+};
+}
+
+#ifdef PROFILE_BUILD
+	#define PROFILE_SCOPE(region) DRAMSim::SimProfiler::Scope profileScope(DRAMSim::SimProfiler::region);
+	#define PROFILE_COUNT_TRANSACTION() DRAMSim::SimProfiler::countTransaction();
+#else
+	#define PROFILE_SCOPE(region) ;
+	#define PROFILE_COUNT_TRANSACTION() ;
+#endif
+
+#endif
@@ -0,0 +1,208 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+//StatsWriter.cpp
+//
+//Class file for the epoch statistics (vis file) writer
+//
+
+#include <stdio.h>
+#include <string.h>
+#include "StatsWriter.h"
+#include "SimProfiler.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+// enough for any double printed with %g and the comma after it
+static const size_t MAX_CELL_LEN = 32;
+
+StatsWriter::StatsWriter(ostream &output_, VisFileFormat format_) :
+	output(output_),
+	format(format_),
+	rowStart(0),
+	rowEnd(0),
+	headerWritten(false)
+{}
+
+unsigned StatsWriter::addColumn(const string &name)
+{
+	if (headerWritten)
+	{
+		ERROR("== Error - Stats column '"<<name<<"' added after the header was written");
+		exit(-1);
+	}
+	columnNames.push_back(name);
+	row.push_back(0.0);
+	return columnNames.size()-1;
+}
+
+string StatsWriter::indexedName(const char *baseName, unsigned channel)
+{
+	char tmp_str[128];
+	snprintf(tmp_str, sizeof(tmp_str), "%s[%u]", baseName, channel);
+	return string(tmp_str);
+}
+
+string StatsWriter::indexedName(const char *baseName, unsigned channel, unsigned rank)
+{
+	char tmp_str[128];
+	snprintf(tmp_str, sizeof(tmp_str), "%s[%u][%u]", baseName, channel, rank);
+	return string(tmp_str);
+}
+
+string StatsWriter::indexedName(const char *baseName, unsigned channel, unsigned rank, unsigned bank)
+{
+	char tmp_str[128];
+	snprintf(tmp_str, sizeof(tmp_str), "%s[%u][%u][%u]", baseName, channel, rank, bank);
+	return string(tmp_str);
+}
+
+size_t StatsWriter::numColumns() const
+{
+	return columnNames.size();
+}
+
+void StatsWriter::writeHeader()
+{
+	if (format == BinaryVisFile)
+	{
+		uint32_t count = columnNames.size();
+		output.write("DRAMSTAT", 8);
+		output.write((const char *)&count, sizeof(count));
+		for (size_t i=0; i<columnNames.size(); i++)
+		{
+			output.write(columnNames[i].c_str(), columnNames[i].length()+1);
+		}
+	}
+	else
+	{
+		for (size_t i=0; i<columnNames.size(); i++)
+		{
+			output << columnNames[i] << ",";
+		}
+		output << endl;
+		textBuffer.resize(columnNames.size() * MAX_CELL_LEN);
+	}
+	output.flush();
+	headerWritten = true;
+}
+
+// formats the pending cells up to (not including) end in one go
+void StatsWriter::writeCells(size_t end)
+{
+	if (end <= rowStart)
+	{
+		return;
+	}
+	char *buffer = &textBuffer[0];
+	size_t length = 0;
+	for (size_t i=rowStart; i<end; i++)
+	{
+		// %g is what an ostream does with a double by default
+		length += snprintf(buffer + length, MAX_CELL_LEN, "%g,", row[i]);
+	}
+	output.write(buffer, length);
+	rowStart = end;
+}
+
+void StatsWriter::writeRow()
+{
+	PROFILE_SCOPE(StatsOutput)
+	if (!headerWritten)
+	{
+		writeHeader();
+	}
+	else if (format == BinaryVisFile)
+	{
+		output.put('R');
+		output.write((const char *)&row[0], row.size() * sizeof(double));
+	}
+	else
+	{
+		writeCells(row.size());
+		output.put('\n');
+	}
+	rowStart = 0;
+	rowEnd = 0;
+}
+
+/*
+ * In the csv format the histogram follows the values that were set so far;
+ * this is how the final stats have always looked, with each channel's
+ * histogram after its own columns.
+ */
+void StatsWriter::writeHistogram(unsigned channel, const LatencyHistogram &histogram)
+{
+	if (!headerWritten)
+	{
+		return;
+	}
+
+	if (format == BinaryVisFile)
+	{
+		uint32_t numBins = 0;
+		for (size_t i=0; i<histogram.numBins(); i++)
+		{
+			if (histogram.binCount(i) > 0)
+			{
+				numBins++;
+			}
+		}
+		uint32_t header[2] = {channel, numBins};
+		output.put('H');
+		output.write((const char *)header, sizeof(header));
+		for (size_t i=0; i<histogram.numBins(); i++)
+		{
+			if (histogram.binCount(i) > 0)
+			{
+				uint32_t bounds[2] = {(uint32_t)histogram.binLowerBound(i), (uint32_t)histogram.binUpperBound(i)};
+				uint64_t count = histogram.binCount(i);
+				output.write((const char *)bounds, sizeof(bounds));
+				output.write((const char *)&count, sizeof(count));
+			}
+		}
+	}
+	else
+	{
+		writeCells(rowEnd);
+		output << "!!HISTOGRAM_DATA" << endl;
+		for (size_t i=0; i<histogram.numBins(); i++)
+		{
+			if (histogram.binCount(i) > 0)
+			{
+				output << histogram.binLowerBound(i) << "=" << histogram.binCount(i) << endl;
+			}
+		}
+	}
+}
@@ -0,0 +1,128 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+#ifndef STATSWRITER_H
+#define STATSWRITER_H
+
+//StatsWriter.h
+//
+//Header file for the epoch statistics (vis file) writer
+//
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+#include "SystemConfiguration.h"
+#include "LatencyHistogram.h"
+
+using std::vector;
+using std::ostream;
+using std::string;
+
+namespace DRAMSim
+{
+/*
+ * StatsWriter: writes the per-epoch statistics of the vis file.
+ *
+ * The columns are registered once with addColumn() when the simulator is
+ * built. Every epoch the values are stored into a preallocated row with
+ * set() and writeRow() emits the whole row. The first writeRow() only writes
+ * the header, since there is nothing to report at cycle 0.
+ *
+ * Two formats are supported (VIS_FILE_FORMAT in system.ini):
+ *
+ *   csv:    one line of comma separated column names, then one line of
+ *           values per epoch (each followed by a comma), and
+ *           "!!HISTOGRAM_DATA" followed by latency=count lines for every
+ *           channel at the end of the simulation, one for each non-empty bin
+ *           labeled with its lowest latency. This is the format DRAMVis
+ *           reads.
+ *
+ *   binary: the magic "DRAMSTAT", a uint32 number of columns and the NUL
+ *           terminated column names, followed by records that start with a
+ *           one byte tag:
+ *             'R'  one row: a double for each column
+ *             'H'  a latency histogram: uint32 channel, uint32 number of bins
+ *                  and for each non-empty bin its lowest and highest latency
+ *                  (uint32) and its count (uint64)
+ *           Everything is in host byte order. Since all rows have the same
+ *           size, column c of row i can be found by seeking directly to it.
+ *
+ * In both cases the ini values that IniReader::WriteValuesOut() puts at the
+ * top of the file come first, as text.
+ */
+class StatsWriter
+{
+public:
+	StatsWriter(ostream &output_, VisFileFormat format_);
+
+	unsigned addColumn(const string &name);
+	static string indexedName(const char *baseName, unsigned channel);
+	static string indexedName(const char *baseName, unsigned channel, unsigned rank);
+	static string indexedName(const char *baseName, unsigned channel, unsigned rank, unsigned bank);
+
+	void set(unsigned column, double value)
+	{
+		row[column] = value;
+		if (column >= rowEnd)
+		{
+			rowEnd = column+1;
+		}
+	}
+	void writeRow();
+	void writeHistogram(unsigned channel, const LatencyHistogram &histogram);
+	size_t numColumns() const;
+
+private:
+	void writeHeader();
+	void writeCells(size_t end);
+
+	ostream &output;
+	VisFileFormat format;
+	vector<string> columnNames;
+	vector<double> row;
+	// the cells [rowStart, rowEnd) have been set but not written yet
+	size_t rowStart;
+	size_t rowEnd;
+	bool headerWritten;
+	vector<char> textBuffer;
+
+	//disable copy constructor and assignment operator
+	StatsWriter(const StatsWriter &);
+	StatsWriter &operator=(const StatsWriter &);
+};
+}
+
+#endif
@@ -0,0 +1,125 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+//SubmissionQueue.cpp
+//
+//Class file for the multi-producer request queue of a channel
+//
+
+#include "SubmissionQueue.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+SubmissionQueue::SubmissionQueue(unsigned entries) :
+	writePosition(0),
+	readPosition(0)
+{
+	//round up to a power of two so that the position can be masked
+	uint64_t size = 1;
+	while (size < entries)
+	{
+		size <<= 1;
+	}
+	slots.resize(size);
+	mask = size - 1;
+	for (uint64_t i=0; i<size; i++)
+	{
+		slots[i].sequence = i;
+	}
+}
+
+//safe to call from any number of threads; false if the queue is full
+bool SubmissionQueue::push(bool isWrite, uint64_t address, uint64_t tag)
+{
+	uint64_t position = writePosition;
+	Slot *slot;
+	while (true)
+	{
+		slot = &slots[position & mask];
+		uint64_t sequence = slot->sequence;
+		__sync_synchronize();
+		int64_t difference = (int64_t)sequence - (int64_t)position;
+		if (difference == 0)
+		{
+			//the slot is free for this position, try to claim it
+			uint64_t seen = __sync_val_compare_and_swap(&writePosition, position, position + 1);
+			if (seen == position)
+			{
+				break;
+			}
+			position = seen;
+		}
+		else if (difference < 0)
+		{
+			//the slot still holds the request from one lap ago
+			return false;
+		}
+		else
+		{
+			//another producer got this position first
+			position = writePosition;
+		}
+	}
+
+	slot->address = address;
+	slot->tag = tag;
+	slot->isWrite = isWrite;
+	__sync_synchronize();
+	slot->sequence = position + 1;
+	return true;
+}
+
+//only from the thread that runs the simulation; false if the queue is empty
+bool SubmissionQueue::pop(bool &isWrite, uint64_t &address, uint64_t &tag)
+{
+	Slot *slot = &slots[readPosition & mask];
+	if (slot->sequence != readPosition + 1)
+	{
+		return false;
+	}
+	__sync_synchronize();
+	address = slot->address;
+	tag = slot->tag;
+	isWrite = slot->isWrite;
+	__sync_synchronize();
+	//hand the slot back to the producers for the next lap
+	slot->sequence = readPosition + mask + 1;
+	readPosition++;
+	return true;
+}
+
+bool SubmissionQueue::empty() const
+{
+	return slots[readPosition & mask].sequence != readPosition + 1;
+}
@@ -0,0 +1,90 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+
+#ifndef SUBMISSIONQUEUE_H
+#define SUBMISSIONQUEUE_H
+
+//SubmissionQueue.h
+//
+//Header file for the multi-producer request queue of a channel
+//
+
+#include <vector>
+#include <stdint.h>
+
+namespace DRAMSim
+{
+/*
+ * Lets several CPU threads submit requests to a channel at the same time
+ * without a lock around the memory system. Any thread may push(); only the
+ * thread that calls update() pops, at the start of each memory cycle, and
+ * moves as many requests into the transaction queue as it has room for.
+ *
+ * This is a bounded ring in which every slot carries a sequence number:
+ * a producer claims a slot by advancing the write position with a
+ * compare-and-swap and then publishes the request by bumping the sequence
+ * of its slot, so the consumer never sees a half written request. When the
+ * ring is full, push() fails and the producer has to retry later, which is
+ * how a full transaction queue pushes back on the CPU threads. 
+ */
+class SubmissionQueue
+{
+public:
+	SubmissionQueue(unsigned entries);
+
+	bool push(bool isWrite, uint64_t address, uint64_t tag);
+	bool pop(bool &isWrite, uint64_t &address, uint64_t &tag);
+	bool empty() const;
+
+private:
+	struct Slot
+	{
+		volatile uint64_t sequence;
+		uint64_t address;
+		uint64_t tag;
+		bool isWrite;
+	};
+
+	std::vector<Slot> slots;
+	uint64_t mask;
+	// the positions are on separate cache lines so that the producers and
+	// the consumer do not keep stealing each other's line
+	char pad0[64];
+	volatile uint64_t writePosition; // shared by the producers
+	char pad1[64];
+	uint64_t readPosition; // consumer only
+};
+}
+
+#endif
+
@@ -51,14 +51,23 @@
 
 
 
-//number of latencies per bucket in the latency histogram
-//TODO: move to system ini file
-#define HISTOGRAM_BIN_SIZE 10
-
 extern std::ofstream cmd_verify_out; //used by BusPacket.cpp if VERIFICATION_OUTPUT is enabled
 //extern std::ofstream visDataOut;
 
 //TODO: namespace these to DRAMSim:: 
+#ifdef RELEASE_BUILD
+// in a release build (make RELEASE=1) the debug flags are constants, so the
+// checks in the hot paths and the output behind them are compiled out. The
+// ini keys are still accepted but have no effect (see IniReader.cpp).
+#define VERIFICATION_OUTPUT false
+#define DEBUG_TRANS_Q false
+#define DEBUG_CMD_Q false
+#define DEBUG_ADDR_MAP false
+#define DEBUG_BANKSTATE false
+#define DEBUG_BUS false
+#define DEBUG_BANKS false
+#define DEBUG_POWER false
+#else
 extern bool VERIFICATION_OUTPUT; // output suitable to feed to modelsim
 
 extern bool DEBUG_TRANS_Q;
@@ -68,8 +77,14 @@ extern bool DEBUG_BANKSTATE;
 extern bool DEBUG_BUS;
 extern bool DEBUG_BANKS;
 extern bool DEBUG_POWER;
+#endif
 extern bool USE_LOW_POWER;
 extern bool VIS_FILE_OUTPUT;
+extern unsigned HISTOGRAM_PRECISION;
+extern bool PER_BANK_LATENCY_HISTOGRAMS;
+extern bool LATENCY_BREAKDOWN;
+extern bool ASYNC_LOG;
+extern bool BUS_LOG;
 
 extern uint64_t TOTAL_STORAGE;
 extern unsigned NUM_BANKS;
@@ -141,6 +156,12 @@ extern std::string ROW_BUFFER_POLICY;
 extern std::string SCHEDULING_POLICY;
 extern std::string ADDRESS_MAPPING_SCHEME;
 extern std::string QUEUING_STRUCTURE;
+extern std::string VIS_FILE_FORMAT;
+extern std::string LIVE_STATS_SHM;
+extern std::string COMMAND_TRACE;
+extern std::string POWER_MODEL;
+extern std::string MEMORY_MODEL;
+extern std::string FUNCTIONAL_STORE;
 
 enum TraceType
 {
@@ -180,6 +201,35 @@ enum SchedulingPolicy
 	BankThenRankRoundRobin
 };
 
+// Only used in StatsWriter
+enum VisFileFormat
+{
+	CSVVisFile,
+	BinaryVisFile
+};
+
+// Only used in CommandTrace
+enum CommandTraceFormat
+{
+	NoCommandTrace,
+	RawCommandTrace,
+	GzipCommandTrace
+};
+
+// Only used in PowerModel
+enum PowerModelType
+{
+	LegacyPower,
+	DetailedPower
+};
+
+// Only used in MemorySystem
+enum MemoryModelType
+{
+	DetailedModel,
+	FastModel
+};
+
 
 // set by IniReader.cpp
 
@@ -193,6 +243,10 @@ extern RowBufferPolicy rowBufferPolicy;
 extern SchedulingPolicy schedulingPolicy;
 extern AddressMappingScheme addressMappingScheme;
 extern QueuingStructure queuingStructure;
+extern VisFileFormat visFileFormat;
+extern CommandTraceFormat commandTraceFormat;
+extern PowerModelType powerModelType;
+extern MemoryModelType memoryModelType;
 //
 //FUNCTIONS
 //
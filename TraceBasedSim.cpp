@@ -39,14 +39,24 @@
 #include <fstream>
 #include <sstream>
 #include <getopt.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
 #include <map>
+#include <set>
 #include <list>
+#include <deque>
+#include <queue>
+#include <cmath>
 
 #include "SystemConfiguration.h"
 #include "MemorySystem.h"
 #include "MultiChannelMemorySystem.h"
 #include "Transaction.h"
 #include "IniReader.h"
+#include "TrafficGenerator.h"
+#include "LatencyHistogram.h"
+#include "SimProfiler.h"
 
 
 using namespace DRAMSim;
@@ -58,89 +68,16 @@ using namespace std;
 int SHOW_SIM_OUTPUT = 1;
 ofstream visDataOut; //mostly used in MemoryController
 
-#ifdef RETURN_TRANSACTIONS
-class TransactionReceiver
-{
-	private: 
-		map<uint64_t, list<uint64_t> > pendingReadRequests; 
-		map<uint64_t, list<uint64_t> > pendingWriteRequests; 
-
-	public: 
-		void add_pending(const Transaction &t, uint64_t cycle)
-		{
-			// C++ lists are ordered, so the list will always push to the back and
-			// remove at the front to ensure ordering
-			if (t.transactionType == DATA_READ)
-			{
-				pendingReadRequests[t.address].push_back(cycle); 
-			}
-			else if (t.transactionType == DATA_WRITE)
-			{
-				pendingWriteRequests[t.address].push_back(cycle); 
-			}
-			else
-			{
-				ERROR("This should never happen"); 
-				exit(-1);
-			}
-		}
-
-		void read_complete(unsigned id, uint64_t address, uint64_t done_cycle)
-		{
-			map<uint64_t, list<uint64_t> >::iterator it;
-			it = pendingReadRequests.find(address); 
-			if (it == pendingReadRequests.end())
-			{
-				ERROR("Cant find a pending read for this one"); 
-				exit(-1);
-			}
-			else
-			{
-				if (it->second.size() == 0)
-				{
-					ERROR("Nothing here, either"); 
-					exit(-1); 
-				}
-			}
-
-			uint64_t added_cycle = pendingReadRequests[address].front();
-			uint64_t latency = done_cycle - added_cycle;
-
-			pendingReadRequests[address].pop_front();
-			cout << "Read Callback:  0x"<< std::hex << address << std::dec << " latency="<<latency<<"cycles ("<< done_cycle<< "->"<<added_cycle<<")"<<endl;
-		}
-		void write_complete(unsigned id, uint64_t address, uint64_t done_cycle)
-		{
-			map<uint64_t, list<uint64_t> >::iterator it;
-			it = pendingWriteRequests.find(address); 
-			if (it == pendingWriteRequests.end())
-			{
-				ERROR("Cant find a pending read for this one"); 
-				exit(-1);
-			}
-			else
-			{
-				if (it->second.size() == 0)
-				{
-					ERROR("Nothing here, either"); 
-					exit(-1); 
-				}
-			}
-
-			uint64_t added_cycle = pendingWriteRequests[address].front();
-			uint64_t latency = done_cycle - added_cycle;
-
-			pendingWriteRequests[address].pop_front();
-			cout << "Write Callback: 0x"<< std::hex << address << std::dec << " latency="<<latency<<"cycles ("<< done_cycle<< "->"<<added_cycle<<")"<<endl;
-		}
-};
-#endif
-
 void usage()
 {
 	cout << "DRAMSim2 Usage: " << endl;
 	cout << "DRAMSim -t tracefile -s system.ini -d ini/device.ini [-c #] [-p pwd] [-q] [-S 2048] [-n] [-o OPTION_A=1234,tRC=14,tFAW=19]" <<endl;
-	cout << "\t-t, --tracefile=FILENAME \tspecify a tracefile to run  "<<endl;
+	cout << "DRAMSim -g generator[:key=value,...] -s system.ini -d ini/device.ini [-c #] ..." <<endl;
+	cout << "\t-t, --tracefile=FILENAME[:ID[:OFFSET]] \tspecify a tracefile to run; repeat -t to replay several traces"<<endl;
+	cout << "\t\t\t\t\tside by side, each with its own requester ID and address offset"<<endl;
+	cout << "\t-g, --generator=TYPE[:OPTS] \tuse a synthetic traffic generator instead of a tracefile"<<endl;
+	cout << "\t\t\t\t\tTYPE is one of stream, random, stride, conflict, hotrow, mixed"<<endl;
+	cout << "\t\t\t\t\tOPTS is a list of rate=R,outstanding=N,writes=F,footprint=MB,stride=B,rows=N,seed=S"<<endl;
 	cout << "\t-s, --systemini=FILENAME \tspecify an ini file that describes the memory system parameters  "<<endl;
 	cout << "\t-d, --deviceini=FILENAME \tspecify an ini file that describes the device-level parameters"<<endl;
 	cout << "\t-c, --numcycles=# \t\tspecify number of cycles to run the simulation for [default=30] "<<endl;
@@ -150,6 +87,15 @@ void usage()
 	cout << "\t-S, --size=# \t\t\tSize of the memory system in megabytes [default=2048M]"<<endl;
 	cout << "\t-n, --notiming \t\t\tDo not use the clock cycle information in the trace file"<<endl;
 	cout << "\t-v, --visfile \t\t\tVis output filename"<<endl;
+	cout << "\t-b, --benchmark=FILENAME \tsweep the generator's injection rate and write a loaded latency curve (CSV) to FILENAME"<<endl;
+	cout << "\t\t\t\t\t-c is then the number of cycles measured per point [default generator=random]"<<endl;
+	cout << "\t-F, --sample=DETAIL:SKIP[:WARMUP] \tsampled simulation: simulate DETAIL cycles (after WARMUP cycles, default DETAIL/10),"<<endl;
+	cout << "\t\t\t\t\tthen fast-forward SKIP cycles, and estimate bandwidth and latency from the samples"<<endl;
+	cout << "\t-L, --closedloop=# \t\treplay the trace closed-loop with at most # outstanding reads per trace;"<<endl;
+	cout << "\t\t\t\t\tgaps between requests are taken from the trace, latency delays the rest of it"<<endl;
+	cout << "\t-w, --sweep=KEY=V1:V2[,KEY=...]\trun the trace once for every combination of these ini values"<<endl;
+	cout << "\t\t\t\t\t(on top of -o) and print the results as one CSV table"<<endl;
+	cout << "\t-j, --jobs=# \t\t\tnumber of sweep configurations to run at once [default=number of CPUs]"<<endl;
 }
 #endif
 
@@ -296,8 +242,9 @@ void *parseTraceFileLine(string &line, uint64_t &addr, enum TransactionType &tra
 #ifndef NO_STORAGE
 		if (dataStr.size() > 0 && transType == DATA_WRITE)
 		{
-			// 32 bytes of data per transaction
-			dataBuffer = (uint64_t *)calloc(sizeof(uint64_t),4);
+			// up to 32 bytes of data per transaction, in a buffer of
+			// TRANSACTION_SIZE bytes (the bank copies that many)
+			dataBuffer = (uint64_t *)calloc(max(TRANSACTION_SIZE, 4 * (unsigned)sizeof(uint64_t)), 1);
 			size_t strlen = dataStr.size();
 			for (int i=0; i < 4; i++)
 			{
@@ -312,7 +259,10 @@ void *parseTraceFileLine(string &line, uint64_t &addr, enum TransactionType &tra
 				iss >> hex >> dataBuffer[i];
 			}
 			PRINTN("\tDATA=");
-			BusPacket::printData(dataBuffer);
+			for (int i=0; i < 4; i++)
+			{
+				PRINTN(hex << dataBuffer[i] << dec << " ");
+			}
 		}
 
 		PRINT("");
@@ -334,282 +284,1434 @@ void alignTransactionAddress(Transaction &trans)
 	trans.address <<= throwAwayBits;
 }
 
-/** 
- * Override options can be specified on the command line as -o key1=value1,key2=value2
- * this method should parse the key-value pairs and put them into a map 
- **/ 
-IniReader::OverrideMap *parseParamOverrides(const string &kv_str)
+/**
+ * A trace file read and parsed once, so that the configurations of a sweep
+ * (see runSweep()) replay it from memory instead of each parsing the file
+ * again. Blank lines are kept so that the trace is consumed exactly like the
+ * file would be, one line per fetch. Write data is not kept (the simulator
+ * is built without storage).
+ **/
+struct ParsedTrace
 {
-	IniReader::OverrideMap *kv_map = new IniReader::OverrideMap(); 
-	size_t start = 0, comma=0, equal_sign=0;
-	// split the commas if they are there
-	while (1)
+	struct Line
 	{
-		equal_sign = kv_str.find('=', start); 
-		if (equal_sign == string::npos)
+		uint64_t address;
+		uint64_t clockCycle;
+		TransactionType transType;
+		bool blank;
+	};
+
+	ParsedTrace(const string &filename, TraceType traceType, bool useClockCycle)
+	{
+		ifstream traceFile(filename.c_str());
+		if (!traceFile.is_open())
 		{
-			break;
+			cout << "== Error - Could not open trace file"<<endl;
+			exit(0);
 		}
-
-		comma = kv_str.find(',', equal_sign);
-		if (comma == string::npos)
+		uint64_t clockCycle = 0;
+		while (!traceFile.eof())
 		{
-			comma = kv_str.length();
+			string line;
+			getline(traceFile, line);
+			Line parsed = {0, clockCycle, DATA_READ, line.size() == 0};
+			if (!parsed.blank)
+			{
+				parseTraceFileLine(line, parsed.address, parsed.transType, clockCycle, traceType, useClockCycle);
+				parsed.clockCycle = clockCycle;
+			}
+			lines.push_back(parsed);
 		}
-
-		string key = kv_str.substr(start, equal_sign-start);
-		string value = kv_str.substr(equal_sign+1, comma-equal_sign-1); 
-
-		(*kv_map)[key] = value; 
-		start = comma+1;
-
 	}
-	return kv_map; 
-}
 
-int main(int argc, char **argv)
-{
-	int c;
-	TraceType traceType;
-	string traceFileName;
-	string systemIniFilename("system.ini");
-	string deviceIniFilename;
-	string pwdString;
-	string *visFilename = NULL;
-	unsigned megsOfMemory=2048;
-	bool useClockCycle=true;
-	
-	IniReader::OverrideMap *paramOverrides = NULL; 
+	vector<Line> lines;
+};
 
-	unsigned numCycles=1000;
-	//getopt stuff
-	while (1)
+/**
+ * One request stream (i.e. one trace file, usually one core) being replayed
+ * into the memory system. Only the next request of the trace is held in
+ * memory. Its addresses are shifted by addressOffset so that several traces
+ * can be given separate address spaces.
+ **/
+class TraceRequester
+{
+public:
+	TraceRequester(const string &filename_, TraceType traceType_, unsigned id_, uint64_t addressOffset_, const ParsedTrace *parsedTrace_) :
+		filename(filename_),
+		traceType(traceType_),
+		id(id_),
+		addressOffset(addressOffset_),
+		lineNumber(0),
+		head(NULL),
+		traceClockCycle(0),
+		readyCycle(0),
+		lastTraceClockCycle(0),
+		lastIssueCycle(0),
+		lastIssueTraceClockCycle(0),
+		outstandingReads(0),
+		readsIssued(0),
+		writesIssued(0),
+		readsCompleted(0),
+		writesCompleted(0),
+		totalReadLatency(0),
+		readLatencies(HISTOGRAM_PRECISION),
+		mshrStallCycles(0),
+		fastForwarded(0),
+		lastCompletionCycle(0),
+		parsedTrace(parsedTrace_),
+		parsedLine(0)
 	{
-		static struct option long_options[] =
-		{
-			{"deviceini", required_argument, 0, 'd'},
-			{"tracefile", required_argument, 0, 't'},
-			{"systemini", required_argument, 0, 's'},
-
-			{"pwd", required_argument, 0, 'p'},
-			{"numcycles",  required_argument,	0, 'c'},
-			{"option",  required_argument,	0, 'o'},
-			{"quiet",  no_argument, &SHOW_SIM_OUTPUT, 'q'},
-			{"help", no_argument, 0, 'h'},
-			{"size", required_argument, 0, 'S'},
-			{"visfile", required_argument, 0, 'v'},
-			{0, 0, 0, 0}
-		};
-		int option_index=0; //for getopt
-		c = getopt_long (argc, argv, "t:s:c:d:o:p:S:v:qn", long_options, &option_index);
-		if (c == -1)
+		if (parsedTrace != NULL)
 		{
-			break;
+			return;
 		}
-		switch (c)
+		traceFile.open(filename.c_str());
+		if (!traceFile.is_open())
 		{
-		case 0: //TODO: figure out what the hell this does, cuz it never seems to get called
-			if (long_options[option_index].flag != 0) //do nothing on a flag
-			{
-				printf("setting flag\n");
-				break;
-			}
-			printf("option %s",long_options[option_index].name);
-			if (optarg)
-			{
-				printf(" with arg %s", optarg);
-			}
-			printf("\n");
-			break;
-		case 'h':
-			usage();
+			cout << "== Error - Could not open trace file"<<endl;
 			exit(0);
-			break;
-		case 't':
-			traceFileName = string(optarg);
-			break;
-		case 's':
-			systemIniFilename = string(optarg);
-			break;
-		case 'd':
-			deviceIniFilename = string(optarg);
-			break;
-		case 'c':
-			numCycles = atoi(optarg);
-			break;
-		case 'S':
-			megsOfMemory=atoi(optarg);
-			break;
-		case 'p':
-			pwdString = string(optarg);
-			break;
-		case 'q':
-			SHOW_SIM_OUTPUT=false;
-			break;
-		case 'n':
-			useClockCycle=false;
-			break;
-		case 'o':
-			paramOverrides = parseParamOverrides(string(optarg)); 
-			break;
-		case 'v':
-			visFilename = new string(optarg);
-			break;
-		case '?':
-			usage();
-			exit(-1);
-			break;
 		}
 	}
 
-	// get the trace filename
-	string temp = traceFileName.substr(traceFileName.find_last_of("/")+1);
-
-	//get the prefix of the trace name
-	temp = temp.substr(0,temp.find_first_of("_"));
-	if (temp=="mase")
-	{
-		traceType = mase;
-	}
-	else if (temp=="k6")
+	~TraceRequester()
 	{
-		traceType = k6;
+		traceFile.close();
+		// make valgrind happy
+		delete head;
 	}
-	else if (temp=="misc")
+
+	/**
+	 * Read the next line of the trace into head. Like the original replay
+	 * loop, each call consumes exactly one line, so blank lines and the end
+	 * of the trace return false.
+	 **/
+	bool fetch(bool useClockCycle)
 	{
-		traceType = misc;
+		PROFILE_SCOPE(TraceParsing)
+		if (atEnd())
+		{
+			return false;
+		}
+		if (parsedTrace != NULL)
+		{
+			return fetchParsed();
+		}
+
+		string line;
+		uint64_t addr;
+		enum TransactionType transType;
+
+		getline(traceFile, line);
+		if (line.size() == 0)
+		{
+			DEBUG("WARNING: Skipping line "<<lineNumber<< " ('" << line << "') in tracefile");
+			lineNumber++;
+			return false;
+		}
+		lineNumber++;
+
+		void *data = parseTraceFileLine(line, addr, transType, traceClockCycle, traceType, useClockCycle);
+		head = new Transaction(transType, addr + addressOffset, data);
+		alignTransactionAddress(*head);
+		return true;
 	}
-	else
+
+	bool fetchParsed()
 	{
-		ERROR("== Unknown Tracefile Type : "<<temp);
-		exit(0);
-	}
+		const ParsedTrace::Line &line = parsedTrace->lines[parsedLine++];
+		if (line.blank)
+		{
+			DEBUG("WARNING: Skipping line "<<lineNumber<< " ('') in tracefile");
+			lineNumber++;
+			return false;
+		}
+		lineNumber++;
 
+		traceClockCycle = line.clockCycle;
+		head = new Transaction(line.transType, line.address + addressOffset, NULL);
+		alignTransactionAddress(*head);
+		return true;
+	}
 
-	// no default value for the default model name
-	if (deviceIniFilename.length() == 0)
+	bool atEnd() const
 	{
-		ERROR("Please provide a device ini file");
-		usage();
-		exit(-1);
+		if (parsedTrace != NULL)
+		{
+			return parsedLine == parsedTrace->lines.size();
+		}
+		return traceFile.eof();
 	}
 
-
-	//ignore the pwd argument if the argument is an absolute path
-	if (pwdString.length() > 0 && traceFileName[0] != '/')
+	bool done() const
 	{
-		traceFileName = pwdString + "/" +traceFileName;
+		return head == NULL && atEnd() && outstandingReads == 0;
 	}
 
-	DEBUG("== Loading trace file '"<<traceFileName<<"' == ");
-
+	string filename;
 	ifstream traceFile;
-	string line;
-
-
-	MultiChannelMemorySystem *memorySystem = new MultiChannelMemorySystem(deviceIniFilename, systemIniFilename, pwdString, traceFileName, megsOfMemory, visFilename, paramOverrides);
-	// set the frequency ratio to 1:1
-	memorySystem->setCPUClockSpeed(0); 
-
-	// don't need this anymore 
-	delete paramOverrides;
+	TraceType traceType;
+	unsigned id;
+	uint64_t addressOffset;
+	int lineNumber;
+
+	// the next request and the cycle at which it may be issued
+	Transaction *head;
+	uint64_t traceClockCycle;
+	uint64_t readyCycle;
+
+	// closed-loop bookkeeping
+	uint64_t lastTraceClockCycle;
+	uint64_t lastIssueCycle;
+	uint64_t lastIssueTraceClockCycle;
+	unsigned outstandingReads;
+
+	// statistics
+	uint64_t readsIssued;
+	uint64_t writesIssued;
+	uint64_t readsCompleted;
+	uint64_t writesCompleted;
+	uint64_t totalReadLatency;
+	LatencyHistogram readLatencies;
+	uint64_t mshrStallCycles;
+	uint64_t fastForwarded;
+	uint64_t lastCompletionCycle;
+
+	// only when replaying a trace that was parsed in advance
+	const ParsedTrace *parsedTrace;
+	size_t parsedLine;
+};
 
+/**
+ * Replays trace files into the memory system.
+ *
+ * Several traces can share the memory system, e.g. one per core. They are
+ * merged by the cycle at which their next request is ready (a k-way merge
+ * over the head of each trace), so no trace is ever loaded completely. Each
+ * requester can issue at most one request per cycle.
+ *
+ * In open-loop mode (maxOutstandingReads == 0) a request is issued at its
+ * trace clock cycle, or as soon after that as the memory system accepts it.
+ *
+ * In closed-loop mode each requester may only have maxOutstandingReads reads
+ * in flight, like a core with that many MSHRs. The trace timestamps are then
+ * only used for the gaps between consecutive requests: a request becomes ready
+ * one gap after the previous request was actually issued, and a read that
+ * finds all MSHRs busy waits for a read callback to free one. Memory latency
+ * therefore feeds back into when the rest of the trace is issued.
+ **/
+class TraceReplayer
+{
+public:
+	TraceReplayer(MultiChannelMemorySystem *memorySystem_, unsigned maxOutstandingReads_, bool useClockCycle_) :
+		memorySystem(memorySystem_),
+		maxOutstandingReads(maxOutstandingReads_),
+		useClockCycle(useClockCycle_),
+		currentClockCycle(0),
+		intervalReads(0),
+		intervalWrites(0),
+		intervalReadLatency(0)
+	{
+		readCB = new Callback<TraceReplayer, void, unsigned, uint64_t, uint64_t>(this, &TraceReplayer::read_complete);
+		writeCB = new Callback<TraceReplayer, void, unsigned, uint64_t, uint64_t>(this, &TraceReplayer::write_complete);
+		memorySystem->RegisterCallbacks(readCB, writeCB, NULL);
+	}
 
-#ifdef RETURN_TRANSACTIONS
-	TransactionReceiver transactionReceiver; 
-	/* create and register our callback functions */
-	Callback_t *read_cb = new Callback<TransactionReceiver, void, unsigned, uint64_t, uint64_t>(&transactionReceiver, &TransactionReceiver::read_complete);
-	Callback_t *write_cb = new Callback<TransactionReceiver, void, unsigned, uint64_t, uint64_t>(&transactionReceiver, &TransactionReceiver::write_complete);
-	memorySystem->RegisterCallbacks(read_cb, write_cb, NULL);
-#endif
+	~TraceReplayer()
+	{
+		for (size_t i=0; i<requesters.size(); i++)
+		{
+			delete requesters[i];
+		}
+		delete readCB;
+		delete writeCB;
+	}
 
+	void addTrace(const string &filename, TraceType traceType, unsigned id, uint64_t addressOffset, const ParsedTrace *parsedTrace=NULL)
+	{
+		for (size_t r=0; r<requesters.size(); r++)
+		{
+			if (requesters[r]->id == id)
+			{
+				ERROR("Requester ID "<<id<<" is used by more than one trace");
+				exit(-1);
+			}
+		}
+		DEBUG("== Loading trace file '"<<filename<<"' == ");
+		TraceRequester *requester = new TraceRequester(filename, traceType, id, addressOffset, parsedTrace);
+		requesters.push_back(requester);
+		fetching.push_back(requester);
+	}
 
-	uint64_t addr;
-	uint64_t clockCycle=0;
-	enum TransactionType transType;
+	/**
+	 * Issue the requests that are ready this cycle, oldest first. With
+	 * canIssue=false only time passes, e.g. while draining the memory system.
+	 **/
+	void update(bool canIssue=true)
+	{
+		if (!canIssue)
+		{
+			currentClockCycle++;
+			return;
+		}
 
-	void *data = NULL;
-	int lineNumber = 0;
-	Transaction *trans=NULL;
-	bool pendingTrans = false;
+		// requesters that issued last cycle read their next request now
+		for (size_t r=0; r<fetching.size(); )
+		{
+			TraceRequester *requester = fetching[r];
+			if (requester->fetch(useClockCycle))
+			{
+				setReadyCycle(requester);
+				ready.push(requester);
+			}
+			else if (!requester->atEnd())
+			{
+				// skipped a blank line, try again next cycle
+				r++;
+				continue;
+			}
+			fetching[r] = fetching.back();
+			fetching.pop_back();
+		}
 
-	traceFile.open(traceFileName.c_str());
+		while (!ready.empty() && ready.top()->readyCycle <= currentClockCycle)
+		{
+			TraceRequester *requester = ready.top();
+			ready.pop();
+			if (issue(requester))
+			{
+				fetching.push_back(requester);
+			}
+			else
+			{
+				blocked.push_back(requester);
+			}
+		}
+		for (size_t r=0; r<blocked.size(); r++)
+		{
+			ready.push(blocked[r]);
+		}
+		blocked.clear();
 
-	if (!traceFile.is_open())
-	{
-		cout << "== Error - Could not open trace file"<<endl;
-		exit(0);
+		currentClockCycle++;
 	}
 
-	for (size_t i=0;i<numCycles;i++)
+	/**
+	 * Skip the next cycles without timing them. The requests that fall into
+	 * them are applied to the memory system with functionalAccess() at their
+	 * ready cycle, which only opens their row. The memory system has to be
+	 * idle.
+	 **/
+	void fastForward(uint64_t cycles)
 	{
-		if (!pendingTrans)
+		uint64_t endCycle = currentClockCycle + cycles;
+		while (true)
 		{
-			if (!traceFile.eof())
+			for (size_t r=0; r<fetching.size(); )
 			{
-				getline(traceFile, line);
-
-				if (line.size() > 0)
+				TraceRequester *requester = fetching[r];
+				if (requester->fetch(useClockCycle))
 				{
-					data = parseTraceFileLine(line, addr, transType,clockCycle, traceType,useClockCycle);
-					trans = new Transaction(transType, addr, data);
-					alignTransactionAddress(*trans); 
-
-					if (i>=clockCycle)
-					{
-						if (!(*memorySystem).addTransaction(trans))
-						{
-							pendingTrans = true;
-						}
-						else
-						{
-#ifdef RETURN_TRANSACTIONS
-							transactionReceiver.add_pending(trans, i); 
-#endif
-							// the memory system accepted our request so now it takes ownership of it
-							trans = NULL; 
-						}
-					}
-					else
-					{
-						pendingTrans = true;
-					}
+					setReadyCycle(requester);
+					ready.push(requester);
 				}
-				else
+				else if (!requester->atEnd())
 				{
-					DEBUG("WARNING: Skipping line "<<lineNumber<< " ('" << line << "') in tracefile");
+					continue;
 				}
-				lineNumber++;
+				fetching[r] = fetching.back();
+				fetching.pop_back();
 			}
-			else
+
+			if (ready.empty() || ready.top()->readyCycle >= endCycle)
 			{
-				//we're out of trace, set pending=false and let the thing spin without adding transactions
-				pendingTrans = false; 
+				break;
 			}
-		}
 
-		else if (pendingTrans && i >= clockCycle)
-		{
-			pendingTrans = !(*memorySystem).addTransaction(trans);
-			if (!pendingTrans)
+			TraceRequester *requester = ready.top();
+			ready.pop();
+			if (requester->readyCycle > currentClockCycle)
 			{
-#ifdef RETURN_TRANSACTIONS
-				transactionReceiver.add_pending(trans, i); 
-#endif
-				trans=NULL;
+				memorySystem->fastForward(requester->readyCycle - currentClockCycle);
+				currentClockCycle = requester->readyCycle;
 			}
+			memorySystem->functionalAccess(requester->head->address);
+
+			delete requester->head;
+			requester->head = NULL;
+			requester->lastIssueCycle = currentClockCycle;
+			requester->lastIssueTraceClockCycle = requester->traceClockCycle;
+			requester->fastForwarded++;
+			fetching.push_back(requester);
 		}
+		memorySystem->fastForward(endCycle - currentClockCycle);
+		currentClockCycle = endCycle;
+	}
 
-		(*memorySystem).update();
+	/**
+	 * Statistics of everything that completed since the last resetInterval(),
+	 * summed over all requesters
+	 **/
+	void resetInterval()
+	{
+		intervalReads = 0;
+		intervalWrites = 0;
+		intervalReadLatency = 0;
 	}
 
-	traceFile.close();
-	memorySystem->printStats(true);
-	// make valgrind happy
-	if (trans)
+	void getInterval(uint64_t &reads, uint64_t &writes, uint64_t &readLatency) const
 	{
-		delete trans;
+		reads = intervalReads;
+		writes = intervalWrites;
+		readLatency = intervalReadLatency;
+	}
+
+	bool finished() const
+	{
+		for (size_t r=0; r<requesters.size(); r++)
+		{
+			if (!requesters[r]->done())
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void read_complete(unsigned id, uint64_t address, uint64_t done_cycle)
+	{
+		PendingMap::iterator it = pendingReads.find(address);
+		if (it == pendingReads.end() || it->second.size() == 0)
+		{
+			ERROR("Cant find a pending read for this one");
+			exit(-1);
+		}
+
+		TraceRequester *requester = it->second.front().first;
+		uint64_t added_cycle = it->second.front().second;
+		uint64_t latency = done_cycle - added_cycle;
+		it->second.pop_front();
+		if (it->second.size() == 0)
+		{
+			pendingReads.erase(it);
+		}
+
+		requester->outstandingReads--;
+		requester->readsCompleted++;
+		intervalReads++;
+		intervalReadLatency += latency;
+		requester->totalReadLatency += latency;
+		requester->readLatencies.insert(latency);
+		requester->lastCompletionCycle = done_cycle;
+#ifdef RETURN_TRANSACTIONS
+		cout << "Read Callback:  0x"<< std::hex << address << std::dec << " latency="<<latency<<"cycles ("<< done_cycle<< "->"<<added_cycle<<")"<<endl;
+#endif
+	}
+
+	void write_complete(unsigned id, uint64_t address, uint64_t done_cycle)
+	{
+		PendingMap::iterator it = pendingWrites.find(address);
+		if (it == pendingWrites.end() || it->second.size() == 0)
+		{
+			ERROR("Cant find a pending write for this one");
+			exit(-1);
+		}
+
+		TraceRequester *requester = it->second.front().first;
+#ifdef RETURN_TRANSACTIONS
+		uint64_t added_cycle = it->second.front().second;
+		cout << "Write Callback: 0x"<< std::hex << address << std::dec << " latency="<<(done_cycle - added_cycle)<<"cycles ("<< done_cycle<< "->"<<added_cycle<<")"<<endl;
+#endif
+		it->second.pop_front();
+		if (it->second.size() == 0)
+		{
+			pendingWrites.erase(it);
+		}
+
+		requester->writesCompleted++;
+		intervalWrites++;
+		requester->lastCompletionCycle = done_cycle;
+	}
+
+	/**
+	 * The results of a sweep configuration as a CSV row (see runSweep()):
+	 * requests completed, bandwidth, read latency and the cycle at which
+	 * the last trace finished (0 if not all of them did)
+	 **/
+	string summaryRow() const
+	{
+		LatencyHistogram latencies(HISTOGRAM_PRECISION);
+		uint64_t reads = 0, writes = 0, totalReadLatency = 0, finishedCycle = 0;
+		bool allDone = true;
+		for (size_t r=0; r<requesters.size(); r++)
+		{
+			TraceRequester *requester = requesters[r];
+			reads += requester->readsCompleted;
+			writes += requester->writesCompleted;
+			totalReadLatency += requester->totalReadLatency;
+			latencies.merge(requester->readLatencies);
+			if (requester->done())
+			{
+				finishedCycle = max(finishedCycle, requester->lastCompletionCycle);
+			}
+			else
+			{
+				allDone = false;
+			}
+		}
+
+		double seconds = currentClockCycle * tCK * 1E-9;
+		stringstream row;
+		row << reads << "," << writes << ","
+			<< (seconds > 0 ? (reads + writes) * TRANSACTION_SIZE / seconds / 1E9 : 0.0) << ","
+			<< (reads > 0 ? (double)totalReadLatency / reads : 0.0) << ","
+			<< latencies.percentile(50.0) << "," << latencies.percentile(99.0) << "," << latencies.max() << ","
+			<< (allDone ? finishedCycle : 0);
+		return row.str();
+	}
+
+	void printStats()
+	{
+		cout << "== Trace replay ("<<(maxOutstandingReads > 0 ? "closed" : "open")<<" loop";
+		if (maxOutstandingReads > 0)
+		{
+			cout << ", "<<maxOutstandingReads<<" outstanding reads per requester";
+		}
+		cout << ") =="<<endl;
+
+		for (size_t r=0; r<requesters.size(); r++)
+		{
+			TraceRequester *requester = requesters[r];
+			uint64_t bytes = (requester->readsCompleted + requester->writesCompleted) * TRANSACTION_SIZE;
+			double seconds = currentClockCycle * tCK * 1E-9;
+			cout << "  ["<<requester->id<<"] "<<requester->filename;
+			if (requester->addressOffset > 0)
+			{
+				cout << " (offset 0x"<<hex<<requester->addressOffset<<dec<<")";
+			}
+			cout << endl;
+			cout << "      reads issued="<<requester->readsIssued<<" completed="<<requester->readsCompleted
+				<<"  writes issued="<<requester->writesIssued<<" completed="<<requester->writesCompleted<<endl;
+			if (seconds > 0)
+			{
+				cout << "      bandwidth="<<bytes / seconds / 1E9<<" GB/s"<<endl;
+			}
+			if (requester->readsCompleted > 0)
+			{
+				const LatencyHistogram &latencies = requester->readLatencies;
+				cout << "      average read latency="<<(double)requester->totalReadLatency / requester->readsCompleted
+					<<" cycles  p50="<<latencies.percentile(50.0)<<" p90="<<latencies.percentile(90.0)
+					<<" p99="<<latencies.percentile(99.0)<<" p99.9="<<latencies.percentile(99.9)
+					<<" max="<<latencies.max()<<" cycles"<<endl;
+			}
+			if (requester->fastForwarded > 0)
+			{
+				cout << "      requests fast-forwarded="<<requester->fastForwarded<<endl;
+			}
+			if (maxOutstandingReads > 0)
+			{
+				cout << "      cycles stalled on full MSHRs="<<requester->mshrStallCycles<<endl;
+				cout << "      last request issued at cycle "<<requester->lastIssueCycle<<" (trace clock "<<requester->lastIssueTraceClockCycle<<")"<<endl;
+			}
+			if (requester->done())
+			{
+				cout << "      finished at cycle "<<requester->lastCompletionCycle;
+				if (useClockCycle && requester->traceClockCycle > 0)
+				{
+					cout << " ("<<(double)requester->lastCompletionCycle / requester->traceClockCycle<<"x the trace's own length of "<<requester->traceClockCycle<<" cycles)";
+				}
+				cout << endl;
+			}
+			else
+			{
+				cout << "      not finished after "<<requester->lineNumber<<" lines"<<endl;
+			}
+		}
+	}
+
+private:
+	typedef map<uint64_t, deque<pair<TraceRequester *, uint64_t> > > PendingMap;
+
+	// orders the heap so that the requester that has been ready the longest is on top
+	struct LaterReady
+	{
+		bool operator()(const TraceRequester *a, const TraceRequester *b) const
+		{
+			if (a->readyCycle != b->readyCycle)
+			{
+				return a->readyCycle > b->readyCycle;
+			}
+			return a->id > b->id;
+		}
+	};
+
+	void setReadyCycle(TraceRequester *requester)
+	{
+		if (maxOutstandingReads > 0)
+		{
+			// keep the gap from the trace, but start it at the actual issue time of the previous request
+			uint64_t gap = 0;
+			if (requester->traceClockCycle > requester->lastTraceClockCycle)
+			{
+				gap = requester->traceClockCycle - requester->lastTraceClockCycle;
+			}
+			requester->readyCycle = requester->lastIssueCycle + gap;
+			requester->lastTraceClockCycle = requester->traceClockCycle;
+		}
+		else
+		{
+			requester->readyCycle = requester->traceClockCycle;
+		}
+	}
+
+	/**
+	 * Try to hand the next request of this requester to the memory system
+	 **/
+	bool issue(TraceRequester *requester)
+	{
+		bool isRead = requester->head->transactionType == DATA_READ;
+		if (isRead && maxOutstandingReads > 0 && requester->outstandingReads >= maxOutstandingReads)
+		{
+			requester->mshrStallCycles++;
+			return false;
+		}
+
+		uint64_t address = requester->head->address;
+		if (!memorySystem->addTransaction(requester->head))
+		{
+			return false;
+		}
+
+		// the memory system accepted our request so now it takes ownership of it
+		requester->head = NULL;
+		requester->lastIssueCycle = currentClockCycle;
+		requester->lastIssueTraceClockCycle = requester->traceClockCycle;
+		if (isRead)
+		{
+			pendingReads[address].push_back(make_pair(requester, currentClockCycle));
+			requester->outstandingReads++;
+			requester->readsIssued++;
+		}
+		else
+		{
+			pendingWrites[address].push_back(make_pair(requester, currentClockCycle));
+			requester->writesIssued++;
+		}
+		return true;
+	}
+
+	MultiChannelMemorySystem *memorySystem;
+	vector<TraceRequester *> requesters;
+	// requesters that need to read their next request, waiting for their ready cycle, and those that could not issue this cycle
+	vector<TraceRequester *> fetching;
+	priority_queue<TraceRequester *, vector<TraceRequester *>, LaterReady> ready;
+	vector<TraceRequester *> blocked;
+	unsigned maxOutstandingReads;
+	bool useClockCycle;
+	uint64_t currentClockCycle;
+
+	uint64_t intervalReads;
+	uint64_t intervalWrites;
+	uint64_t intervalReadLatency;
+
+	// requests in flight, in issue order per address
+	PendingMap pendingReads;
+	PendingMap pendingWrites;
+
+	Callback_t *readCB;
+	Callback_t *writeCB;
+};
+
+/** 
+ * Override options can be specified on the command line as -o key1=value1,key2=value2
+ * this method should parse the key-value pairs and put them into a map 
+ **/ 
+IniReader::OverrideMap *parseParamOverrides(const string &kv_str)
+{
+	IniReader::OverrideMap *kv_map = new IniReader::OverrideMap(); 
+	size_t start = 0, comma=0, equal_sign=0;
+	// split the commas if they are there
+	while (1)
+	{
+		equal_sign = kv_str.find('=', start); 
+		if (equal_sign == string::npos)
+		{
+			break;
+		}
+
+		comma = kv_str.find(',', equal_sign);
+		if (comma == string::npos)
+		{
+			comma = kv_str.length();
+		}
+
+		string key = kv_str.substr(start, equal_sign-start);
+		string value = kv_str.substr(equal_sign+1, comma-equal_sign-1); 
+
+		(*kv_map)[key] = value; 
+		start = comma+1;
+
+	}
+	return kv_map; 
+}
+
+/**
+ * Loaded latency benchmark: run the generator at increasing injection rates
+ * and, for each rate, measure the achieved bandwidth and the read latency
+ * distribution as seen by the memory controllers. The sweep stops once the
+ * memory system saturates (i.e. can't keep up with the offered load or the
+ * latency blows up) and the curve is written as CSV.
+ **/
+void runLatencyBenchmark(MultiChannelMemorySystem *memorySystem, TrafficGenerator *generator, const string &csvFilename, uint64_t cyclesPerPoint)
+{
+	const unsigned numSteps = 20;
+	// each channel can at most return one request every BL/2 cycles
+	double peakRate = (double)NUM_CHANS / (BL/2);
+	uint64_t warmupCycles = cyclesPerPoint / 4;
+	double unloadedLatency = 0.0;
+
+	ofstream csvOut(csvFilename.c_str());
+	if (!csvOut)
+	{
+		ERROR("Cannot open '"<<csvFilename<<"'");
+		exit(-1);
+	}
+	csvOut << "offered_rate,offered_GBps,achieved_GBps,reads,writes,p50_ns,p90_ns,p99_ns,max_ns" << endl;
+	cout << "  offered   achieved(GB/s)    p50(ns)    p90(ns)    p99(ns)    max(ns)" << endl;
+
+	for (unsigned step=1; step<=numSteps; step++)
+	{
+		double rate = peakRate * step / numSteps;
+		generator->setInjectionRate(rate);
+
+		// let the queues settle at the new rate before measuring
+		for (uint64_t i=0; i<warmupCycles; i++)
+		{
+			generator->update();
+			memorySystem->update();
+		}
+		memorySystem->resetLatencyHistogram();
+		uint64_t startReads = generator->readsCompleted;
+		uint64_t startWrites = generator->writesCompleted;
+		uint64_t startIssued = generator->readsIssued + generator->writesIssued;
+
+		for (uint64_t i=0; i<cyclesPerPoint; i++)
+		{
+			generator->update();
+			memorySystem->update();
+		}
+
+		uint64_t reads = generator->readsCompleted - startReads;
+		uint64_t writes = generator->writesCompleted - startWrites;
+		uint64_t issued = generator->readsIssued + generator->writesIssued - startIssued;
+
+		LatencyHistogram histogram(HISTOGRAM_PRECISION);
+		memorySystem->getLatencyHistogram(histogram);
+
+		double seconds = (double)cyclesPerPoint * tCK * 1E-9;
+		double offeredBandwidth = rate * cyclesPerPoint * TRANSACTION_SIZE / seconds / 1E9;
+		double achievedBandwidth = (double)(reads + writes) * TRANSACTION_SIZE / seconds / 1E9;
+		double p50 = histogram.percentile(50.0) * tCK;
+		double p90 = histogram.percentile(90.0) * tCK;
+		double p99 = histogram.percentile(99.0) * tCK;
+		double max = histogram.max() * tCK;
+
+		csvOut << rate << "," << offeredBandwidth << "," << achievedBandwidth << "," << reads << "," << writes << ","
+			<< p50 << "," << p90 << "," << p99 << "," << max << endl;
+		cout << "  " << rate << "\t" << achievedBandwidth << "\t\t" << p50 << "\t" << p90 << "\t" << p99 << "\t" << max << endl;
+
+		if (step == 1)
+		{
+			unloadedLatency = p50;
+		}
+		// saturated: the generator couldn't inject what we asked for or the
+		// queues are blowing up the latency
+		if ((double)issued < 0.9 * rate * cyclesPerPoint || (unloadedLatency > 0.0 && p50 > 10.0 * unloadedLatency))
+		{
+			cout << "== Memory system saturated at an offered rate of " << rate << " requests/cycle" << endl;
+			break;
+		}
+	}
+	csvOut.close();
+}
+
+/**
+ * Half-width of the 95% confidence interval of the mean of the samples
+ * (Student's t distribution, two-sided)
+ **/
+double confidenceInterval95(const vector<double> &samples, double &mean)
+{
+	static const double t95[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+	                             2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+	                             2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+	size_t n = samples.size();
+	mean = 0;
+	for (size_t i=0; i<n; i++)
+	{
+		mean += samples[i];
+	}
+	if (n < 2)
+	{
+		return 0;
+	}
+	mean /= n;
+
+	double variance = 0;
+	for (size_t i=0; i<n; i++)
+	{
+		variance += (samples[i] - mean) * (samples[i] - mean);
+	}
+	variance /= (n - 1);
+
+	double t = (n - 1 <= 30) ? t95[n - 2] : 1.960;
+	return t * sqrt(variance / n);
+}
+
+/**
+ * Sampled replay: alternate detailed intervals with functional fast-forward.
+ * Every period starts with warmupCycles of detailed simulation to refill the
+ * queues, after which the stats are reset and detailCycles are measured. The
+ * memory system is then drained and the next skipCycles are fast-forwarded,
+ * which only keeps track of open rows and refreshes. The bandwidth and read
+ * latency of the whole run are estimated from the measured intervals.
+ **/
+void runSampledReplay(MultiChannelMemorySystem *memorySystem, TraceReplayer *replayer, uint64_t numCycles,
+                      uint64_t detailCycles, uint64_t skipCycles, uint64_t warmupCycles)
+{
+	vector<double> bandwidths, latencies;
+	uint64_t cycle = 0, detailedCycles = 0;
+
+	while (cycle < numCycles && !replayer->finished())
+	{
+		for (uint64_t i=0; i<warmupCycles && cycle < numCycles; i++, cycle++)
+		{
+			replayer->update();
+			memorySystem->update();
+		}
+
+		memorySystem->resetStats();
+		replayer->resetInterval();
+		uint64_t measured = 0;
+		for (; measured<detailCycles && cycle < numCycles; measured++, cycle++)
+		{
+			replayer->update();
+			memorySystem->update();
+		}
+		detailedCycles += warmupCycles + measured;
+		if (measured < detailCycles)
+		{
+			// don't let a partial interval at the end skew the estimate
+			break;
+		}
+
+		uint64_t reads, writes, readLatency;
+		replayer->getInterval(reads, writes, readLatency);
+		bandwidths.push_back((reads + writes) * TRANSACTION_SIZE / (measured * tCK));
+		if (reads > 0)
+		{
+			latencies.push_back((double)readLatency / reads);
+		}
+
+		// fast forwarding needs all requests to be completed
+		while (!memorySystem->isIdle() && cycle < numCycles)
+		{
+			replayer->update(false);
+			memorySystem->update();
+			cycle++;
+			detailedCycles++;
+		}
+		if (cycle >= numCycles)
+		{
+			// -c ran out while draining, the system may still be busy
+			break;
+		}
+
+		uint64_t skip = min(skipCycles, numCycles - cycle);
+		if (skip > 0 && memorySystem->isIdle())
+		{
+			replayer->fastForward(skip);
+			cycle += skip;
+		}
+	}
+
+	double bandwidthMean, latencyMean;
+	double bandwidthCI = confidenceInterval95(bandwidths, bandwidthMean);
+	double latencyCI = confidenceInterval95(latencies, latencyMean);
+
+	cout << "== Sampled simulation: "<<bandwidths.size()<<" intervals of "<<detailCycles<<" cycles ("
+		<<warmupCycles<<" warm-up), "<<skipCycles<<" cycles fast-forwarded in between =="<<endl;
+	cout << "  cycles simulated in detail="<<detailedCycles<<" of "<<cycle
+		<<" ("<<100.0 * detailedCycles / max(cycle, (uint64_t)1)<<"%)"<<endl;
+	if (bandwidths.size() < 2)
+	{
+		cout << "  too few intervals for an estimate, increase -c or shorten the sampling period"<<endl;
+		return;
+	}
+	cout << "  estimated bandwidth="<<bandwidthMean<<" +/- "<<bandwidthCI<<" GB/s (95% confidence)"<<endl;
+	if (latencies.size() >= 2)
+	{
+		cout << "  estimated average read latency="<<latencyMean<<" +/- "<<latencyCI<<" cycles (95% confidence)"<<endl;
+	}
+}
+
+/**
+ * Sweep mode (-w): run the simulation once for every combination of the
+ * values in grid (KEY=V1:V2:...,KEY=..., the same keys as -o).
+ *
+ * The configuration lives in global variables, so the configurations can't
+ * run as threads of one process. Instead each one runs in a process forked
+ * from this one once the traces have been parsed, so they all replay the
+ * same parsed traces (shared copy-on-write) and nothing is parsed twice; at
+ * most jobs of them run at a time. In a child, runSweep() returns the file
+ * descriptor to write the results to, with its values added to
+ * paramOverrides and SIM_DESC set to sweepN so that every configuration
+ * gets its own vis file; its other output is discarded, and LIVE_STATS_SHM
+ * and FUNCTIONAL_STORE are turned off. The parent collects
+ * the results in one CSV table on stdout and exits.
+ **/
+int runSweep(const string &grid, IniReader::OverrideMap *&paramOverrides, unsigned jobs)
+{
+	IniReader::OverrideMap *values = parseParamOverrides(grid);
+	vector<string> keys;
+	vector<vector<string> > choices;
+	for (IniReader::OverrideMap::const_iterator it = values->begin(); it != values->end(); it++)
+	{
+		keys.push_back(it->first);
+		choices.push_back(vector<string>());
+		size_t start = 0;
+		while (true)
+		{
+			size_t colon = it->second.find(':', start);
+			choices.back().push_back(it->second.substr(start, colon - start));
+			if (colon == string::npos)
+			{
+				break;
+			}
+			start = colon + 1;
+		}
+	}
+	delete values;
+	if (keys.empty())
+	{
+		ERROR("Invalid sweep '"<<grid<<"', expected KEY=V1:V2[,KEY=...]");
+		exit(-1);
+	}
+
+	// every combination, the last key varying fastest
+	vector<vector<string> > configs(1);
+	for (size_t k=0; k<keys.size(); k++)
+	{
+		vector<vector<string> > expanded;
+		for (size_t c=0; c<configs.size(); c++)
+		{
+			for (size_t v=0; v<choices[k].size(); v++)
+			{
+				expanded.push_back(configs[c]);
+				expanded.back().push_back(choices[k][v]);
+			}
+		}
+		configs.swap(expanded);
+	}
+
+	vector<string> rows(configs.size(), "failed");
+	map<pid_t, pair<size_t, int> > running; // pid -> config, read end of its pipe
+	size_t next = 0;
+	cout.flush();
+	cerr.flush();
+	while (next < configs.size() || !running.empty())
+	{
+		while (next < configs.size() && running.size() < jobs)
+		{
+			int fds[2];
+			if (pipe(fds) != 0)
+			{
+				ERROR("Cannot create a pipe for the sweep");
+				exit(-1);
+			}
+			pid_t pid = fork();
+			if (pid < 0)
+			{
+				ERROR("Cannot fork for the sweep");
+				exit(-1);
+			}
+			if (pid == 0)
+			{
+				close(fds[0]);
+				int devNull = open("/dev/null", O_WRONLY);
+				dup2(devNull, STDOUT_FILENO);
+				close(devNull);
+
+				stringstream desc;
+				if (getenv("SIM_DESC") != NULL)
+				{
+					desc << getenv("SIM_DESC") << ".";
+				}
+				desc << "sweep" << next;
+				setenv("SIM_DESC", desc.str().c_str(), 1);
+
+				if (paramOverrides == NULL)
+				{
+					paramOverrides = new IniReader::OverrideMap();
+				}
+				// the configurations run side by side, so they can't share
+				// one live stats segment or backing store image (unless
+				// these are swept themselves)
+				(*paramOverrides)["LIVE_STATS_SHM"] = "";
+				(*paramOverrides)["FUNCTIONAL_STORE"] = "";
+				for (size_t k=0; k<keys.size(); k++)
+				{
+					(*paramOverrides)[keys[k]] = configs[next][k];
+				}
+				return fds[1];
+			}
+			close(fds[1]);
+			running[pid] = make_pair(next, fds[0]);
+			next++;
+		}
+
+		int status;
+		pid_t pid = wait(&status);
+		if (pid < 0 || running.find(pid) == running.end())
+		{
+			continue;
+		}
+		size_t config = running[pid].first;
+		int fd = running[pid].second;
+		running.erase(pid);
+
+		string row;
+		char buffer[512];
+		ssize_t length;
+		while ((length = read(fd, buffer, sizeof(buffer))) > 0)
+		{
+			row.append(buffer, length);
+		}
+		close(fd);
+		if (WIFEXITED(status) && WEXITSTATUS(status) == 0 && row.length() > 0)
+		{
+			rows[config] = row.substr(0, row.find('\n'));
+		}
+		else
+		{
+			ERROR("Sweep configuration "<<config<<" failed");
+		}
+	}
+
+	cout << "config";
+	for (size_t k=0; k<keys.size(); k++)
+	{
+		cout << "," << keys[k];
+	}
+	cout << ",reads,writes,bandwidth_GBps,avg_read_latency,p50_read_latency,p99_read_latency,max_read_latency,finished_cycle" << endl;
+	for (size_t c=0; c<configs.size(); c++)
+	{
+		cout << c;
+		for (size_t k=0; k<keys.size(); k++)
+		{
+			cout << "," << configs[c][k];
+		}
+		cout << "," << rows[c] << endl;
+	}
+	exit(0);
+}
+
+/**
+ * The trace format is given by the prefix of the trace's filename
+ **/
+TraceType traceTypeFromFilename(const string &traceFileName)
+{
+	// get the trace filename
+	string temp = traceFileName.substr(traceFileName.find_last_of("/")+1);
+
+	//get the prefix of the trace name
+	temp = temp.substr(0,temp.find_first_of("_"));
+	if (temp=="mase")
+	{
+		return mase;
+	}
+	else if (temp=="k6")
+	{
+		return k6;
+	}
+	else if (temp=="misc")
+	{
+		return misc;
+	}
+	ERROR("== Unknown Tracefile Type : "<<temp);
+	exit(0);
+}
+
+/**
+ * Split a -t argument of the form FILENAME[:ID[:OFFSET]] into its parts.
+ * The ID and address offset can be decimal or 0x-prefixed hex.
+ **/
+void parseTraceSpec(const string &spec, string &filename, unsigned &id, uint64_t &addressOffset)
+{
+	size_t colon = spec.find(':');
+	filename = spec.substr(0, colon);
+	if (colon == string::npos)
+	{
+		return;
+	}
+
+	string rest = spec.substr(colon+1);
+	colon = rest.find(':');
+	string idStr = rest.substr(0, colon);
+	char *end;
+	id = strtoul(idStr.c_str(), &end, 0);
+	if (idStr.length() == 0 || *end != '\0')
+	{
+		ERROR("Invalid requester ID '"<<idStr<<"' in '"<<spec<<"'");
+		exit(-1);
+	}
+	if (colon == string::npos)
+	{
+		return;
+	}
+
+	string offsetStr = rest.substr(colon+1);
+	addressOffset = strtoull(offsetStr.c_str(), &end, 0);
+	if (offsetStr.length() == 0 || *end != '\0')
+	{
+		ERROR("Invalid address offset '"<<offsetStr<<"' in '"<<spec<<"'");
+		exit(-1);
+	}
+}
+
+/**
+ * The requester ID of every -t argument: the one given, or for a trace
+ * without one, the smallest ID that no other trace uses.
+ **/
+vector<unsigned> traceIds(const vector<string> &traceSpecs)
+{
+	vector<unsigned> ids(traceSpecs.size());
+	vector<bool> named(traceSpecs.size());
+	set<unsigned> taken;
+	for (size_t t=0; t<traceSpecs.size(); t++)
+	{
+		string filename;
+		uint64_t addressOffset = 0;
+		named[t] = traceSpecs[t].find(':') != string::npos;
+		if (named[t])
+		{
+			parseTraceSpec(traceSpecs[t], filename, ids[t], addressOffset);
+			taken.insert(ids[t]);
+		}
+	}
+	unsigned next = 0;
+	for (size_t t=0; t<traceSpecs.size(); t++)
+	{
+		if (!named[t])
+		{
+			while (taken.count(next) > 0)
+			{
+				next++;
+			}
+			ids[t] = next++;
+		}
+	}
+	return ids;
+}
+
+int main(int argc, char **argv)
+{
+	int c;
+	string traceFileName;
+	vector<string> traceSpecs;
+	string generatorSpec;
+	string benchmarkFilename;
+	string systemIniFilename("system.ini");
+	string deviceIniFilename;
+	string pwdString;
+	string *visFilename = NULL;
+	unsigned megsOfMemory=2048;
+	bool useClockCycle=true;
+	unsigned maxOutstandingReads=0;
+	uint64_t sampleDetailCycles=0, sampleSkipCycles=0, sampleWarmupCycles=0;
+	string sweepGrid;
+	unsigned sweepJobs = sysconf(_SC_NPROCESSORS_ONLN);
+	
+	IniReader::OverrideMap *paramOverrides = NULL; 
+
+	unsigned numCycles=1000;
+	//getopt stuff
+	while (1)
+	{
+		static struct option long_options[] =
+		{
+			{"deviceini", required_argument, 0, 'd'},
+			{"tracefile", required_argument, 0, 't'},
+			{"generator", required_argument, 0, 'g'},
+			{"systemini", required_argument, 0, 's'},
+
+			{"pwd", required_argument, 0, 'p'},
+			{"numcycles",  required_argument,	0, 'c'},
+			{"option",  required_argument,	0, 'o'},
+			{"quiet",  no_argument, &SHOW_SIM_OUTPUT, 'q'},
+			{"help", no_argument, 0, 'h'},
+			{"size", required_argument, 0, 'S'},
+			{"visfile", required_argument, 0, 'v'},
+			{"benchmark", required_argument, 0, 'b'},
+			{"closedloop", required_argument, 0, 'L'},
+			{"sample", required_argument, 0, 'F'},
+			{"sweep", required_argument, 0, 'w'},
+			{"jobs", required_argument, 0, 'j'},
+			{0, 0, 0, 0}
+		};
+		int option_index=0; //for getopt
+		c = getopt_long (argc, argv, "t:g:s:c:d:o:p:S:v:b:L:F:w:j:qn", long_options, &option_index);
+		if (c == -1)
+		{
+			break;
+		}
+		switch (c)
+		{
+		case 0: //TODO: figure out what the hell this does, cuz it never seems to get called
+			if (long_options[option_index].flag != 0) //do nothing on a flag
+			{
+				printf("setting flag\n");
+				break;
+			}
+			printf("option %s",long_options[option_index].name);
+			if (optarg)
+			{
+				printf(" with arg %s", optarg);
+			}
+			printf("\n");
+			break;
+		case 'h':
+			usage();
+			exit(0);
+			break;
+		case 't':
+			traceSpecs.push_back(string(optarg));
+			break;
+		case 'g':
+			generatorSpec = string(optarg);
+			break;
+		case 's':
+			systemIniFilename = string(optarg);
+			break;
+		case 'd':
+			deviceIniFilename = string(optarg);
+			break;
+		case 'c':
+			numCycles = atoi(optarg);
+			break;
+		case 'S':
+			megsOfMemory=atoi(optarg);
+			break;
+		case 'p':
+			pwdString = string(optarg);
+			break;
+		case 'q':
+			SHOW_SIM_OUTPUT=false;
+			break;
+		case 'n':
+			useClockCycle=false;
+			break;
+		case 'o':
+			paramOverrides = parseParamOverrides(string(optarg)); 
+			break;
+		case 'v':
+			visFilename = new string(optarg);
+			break;
+		case 'b':
+			benchmarkFilename = string(optarg);
+			break;
+		case 'F':
+		{
+			// DETAIL:SKIP[:WARMUP]
+			char *end;
+			sampleDetailCycles = strtoull(optarg, &end, 10);
+			if (*end == ':')
+			{
+				sampleSkipCycles = strtoull(end+1, &end, 10);
+			}
+			sampleWarmupCycles = sampleDetailCycles / 10;
+			if (*end == ':')
+			{
+				sampleWarmupCycles = strtoull(end+1, &end, 10);
+			}
+			if (sampleDetailCycles == 0 || *end != '\0')
+			{
+				ERROR("Invalid sampling parameters '"<<optarg<<"', expected DETAIL:SKIP[:WARMUP]");
+				exit(-1);
+			}
+			break;
+		}
+		case 'w':
+			sweepGrid = string(optarg);
+			break;
+		case 'j':
+			sweepJobs = atoi(optarg);
+			if (sweepJobs == 0)
+			{
+				ERROR("The number of sweep jobs must be at least 1");
+				exit(-1);
+			}
+			break;
+		case 'L':
+			maxOutstandingReads = atoi(optarg);
+			if (maxOutstandingReads == 0)
+			{
+				ERROR("The closed-loop outstanding read limit must be at least 1");
+				exit(-1);
+			}
+			break;
+		case '?':
+			usage();
+			exit(-1);
+			break;
+		}
+	}
+
+	if (benchmarkFilename.length() > 0 && generatorSpec.length() == 0)
+	{
+		generatorSpec = "random";
+	}
+
+	if (generatorSpec.length() > 0)
+	{
+		if (traceSpecs.size() > 0)
+		{
+			ERROR("Please specify either a trace file or a generator, not both");
+			usage();
+			exit(-1);
+		}
+		// the results directory is named after the trace, so name it after the generator instead
+		traceFileName = "gen_" + generatorSpec.substr(0, generatorSpec.find(':'));
+	}
+	else if (traceSpecs.size() > 0)
+	{
+		unsigned id;
+		uint64_t addressOffset;
+		parseTraceSpec(traceSpecs[0], traceFileName, id, addressOffset);
+		if (traceSpecs.size() > 1)
+		{
+			// the results directory is named after the trace, so name it after all of them
+			stringstream ss;
+			ss << "multi" << traceSpecs.size() << "_" << traceFileName.substr(traceFileName.find_last_of("/")+1);
+			traceFileName = ss.str();
+		}
+	}
+	else
+	{
+		ERROR("Please provide a trace file or a generator");
+		usage();
+		exit(-1);
+	}
+
+
+	// no default value for the default model name
+	if (deviceIniFilename.length() == 0)
+	{
+		ERROR("Please provide a device ini file");
+		usage();
+		exit(-1);
+	}
+
+
+	if (sweepGrid.length() > 0 && generatorSpec.length() > 0)
+	{
+		ERROR("A sweep needs trace files, not a generator");
+		exit(-1);
+	}
+
+	// a sweep parses the traces once, before it forks
+	vector<ParsedTrace *> parsedTraces(traceSpecs.size(), (ParsedTrace *)NULL);
+	vector<unsigned> ids = traceIds(traceSpecs);
+	int sweepFd = -1;
+	if (sweepGrid.length() > 0)
+	{
+		for (size_t t=0; t<traceSpecs.size(); t++)
+		{
+			string filename;
+			unsigned id = ids[t];
+			uint64_t addressOffset = 0;
+			parseTraceSpec(traceSpecs[t], filename, id, addressOffset);
+			if (pwdString.length() > 0 && filename[0] != '/')
+			{
+				filename = pwdString + "/" + filename;
+			}
+			parsedTraces[t] = new ParsedTrace(filename, traceTypeFromFilename(filename), useClockCycle);
+		}
+		sweepFd = runSweep(sweepGrid, paramOverrides, sweepJobs);
+	}
+
+	MultiChannelMemorySystem *memorySystem = new MultiChannelMemorySystem(deviceIniFilename, systemIniFilename, pwdString, traceFileName, megsOfMemory, visFilename, paramOverrides);
+	// set the frequency ratio to 1:1
+	memorySystem->setCPUClockSpeed(0); 
+
+	// don't need this anymore 
+	delete paramOverrides;
+
+	if (generatorSpec.length() > 0)
+	{
+		TrafficGenerator *generator = TrafficGenerator::fromString(generatorSpec, memorySystem, (uint64_t)megsOfMemory << 20);
+		if (benchmarkFilename.length() > 0)
+		{
+			runLatencyBenchmark(memorySystem, generator, benchmarkFilename, numCycles);
+		}
+		else
+		{
+			for (size_t i=0;i<numCycles;i++)
+			{
+				generator->update();
+				memorySystem->update();
+			}
+		}
+		memorySystem->printStats(true);
+		generator->printStats();
+		delete generator;
+		delete memorySystem;
+		return 0;
+	}
+
+	TraceReplayer *replayer = new TraceReplayer(memorySystem, maxOutstandingReads, useClockCycle);
+	for (size_t t=0; t<traceSpecs.size(); t++)
+	{
+		string filename;
+		unsigned id = ids[t];
+		uint64_t addressOffset = 0;
+		parseTraceSpec(traceSpecs[t], filename, id, addressOffset);
+
+		//ignore the pwd argument if the argument is an absolute path
+		if (pwdString.length() > 0 && filename[0] != '/')
+		{
+			filename = pwdString + "/" + filename;
+		}
+		replayer->addTrace(filename, traceTypeFromFilename(filename), id, addressOffset, parsedTraces[t]);
+	}
+
+	if (sampleDetailCycles > 0)
+	{
+		runSampledReplay(memorySystem, replayer, numCycles, sampleDetailCycles, sampleSkipCycles, sampleWarmupCycles);
+	}
+	else
+	{
+		for (size_t i=0;i<numCycles;i++)
+		{
+			replayer->update();
+			(*memorySystem).update();
+		}
+	}
+
+	memorySystem->printStats(true);
+	replayer->printStats();
+	if (sweepFd >= 0)
+	{
+		string row = replayer->summaryRow() + "\n";
+		if (write(sweepFd, row.c_str(), row.length()) != (ssize_t)row.length())
+		{
+			exit(-1);
+		}
+		close(sweepFd);
+	}
+	delete replayer;
+	delete(memorySystem);
+	for (size_t t=0; t<parsedTraces.size(); t++)
+	{
+		delete parsedTraces[t];
 	}
-	delete(memorySystem);
 }
 #endif
@@ -0,0 +1,497 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+//TrafficGenerator.cpp
+//
+//Class file for the synthetic traffic generator object
+//
+
+#include "TrafficGenerator.h"
+#include "AddressMapping.h"
+
+using namespace DRAMSim;
+
+TrafficGenerator::TrafficGenerator(MultiChannelMemorySystem *memorySystem_, GeneratorType type_, uint64_t memoryBytes_) :
+	type(type_),
+	currentClockCycle(0),
+	readsIssued(0),
+	writesIssued(0),
+	readsCompleted(0),
+	writesCompleted(0),
+	stallCycles(0),
+	memorySystem(memorySystem_),
+	dramsim_log(memorySystem_->getLogFile()),
+	memoryBytes(memoryBytes_),
+	footprint(memoryBytes_),
+	stride(4096),
+	numHotRows(4),
+	injectionRate(1.0),
+	writeFraction(0.0),
+	maxOutstanding(32),
+	randomState(1),
+	injectionCredit(0.0),
+	pendingRequest(false),
+	pendingIsWrite(false),
+	pendingAddress(0),
+	readCursor(0),
+	writeCursor(0)
+{
+	if (type == Mixed)
+	{
+		writeFraction = 0.5;
+	}
+	setFootprint(memoryBytes);
+	mapAddressBits();
+
+	readCB = new Callback<TrafficGenerator, void, unsigned, uint64_t, uint64_t>(this, &TrafficGenerator::read_complete);
+	writeCB = new Callback<TrafficGenerator, void, unsigned, uint64_t, uint64_t>(this, &TrafficGenerator::write_complete);
+	memorySystem->RegisterCallbacks(readCB, writeCB, NULL);
+}
+
+TrafficGenerator::~TrafficGenerator()
+{
+	delete readCB;
+	delete writeCB;
+}
+
+bool TrafficGenerator::parseType(const string &name, GeneratorType &type)
+{
+	if (name == "stream")
+	{
+		type = Stream;
+	}
+	else if (name == "random")
+	{
+		type = Random;
+	}
+	else if (name == "stride")
+	{
+		type = Strided;
+	}
+	else if (name == "conflict")
+	{
+		type = BankConflict;
+	}
+	else if (name == "hotrow")
+	{
+		type = HotRow;
+	}
+	else if (name == "mixed")
+	{
+		type = Mixed;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+const char *TrafficGenerator::typeName(GeneratorType type)
+{
+	switch (type)
+	{
+		case Stream:
+			return "stream";
+		case Random:
+			return "random";
+		case Strided:
+			return "stride";
+		case BankConflict:
+			return "conflict";
+		case HotRow:
+			return "hotrow";
+		case Mixed:
+			return "mixed";
+	}
+	return "unknown";
+}
+
+/**
+ * Build a generator from a string like "random:rate=0.5,outstanding=16"; see
+ * TrafficGenerator.h for the list of types and keys
+ **/
+TrafficGenerator *TrafficGenerator::fromString(const string &spec, MultiChannelMemorySystem *memorySystem, uint64_t memoryBytes)
+{
+	size_t colon = spec.find(':');
+	string typeStr = spec.substr(0, colon);
+	GeneratorType type;
+
+	if (!parseType(typeStr, type))
+	{
+		ERROR("Unknown traffic generator '"<<typeStr<<"'; valid types are stream, random, stride, conflict, hotrow, mixed");
+		exit(-1);
+	}
+
+	TrafficGenerator *generator = new TrafficGenerator(memorySystem, type, memoryBytes);
+	if (colon == string::npos)
+	{
+		return generator;
+	}
+
+	// same key=value,key=value format as the -o overrides
+	size_t start = colon+1, comma=0, equal_sign=0;
+	while (1)
+	{
+		equal_sign = spec.find('=', start);
+		if (equal_sign == string::npos)
+		{
+			break;
+		}
+
+		comma = spec.find(',', equal_sign);
+		if (comma == string::npos)
+		{
+			comma = spec.length();
+		}
+
+		string key = spec.substr(start, equal_sign-start);
+		string value = spec.substr(equal_sign+1, comma-equal_sign-1);
+		generator->setOption(key, value);
+		start = comma+1;
+	}
+	return generator;
+}
+
+void TrafficGenerator::setOption(const string &key, const string &value)
+{
+	if (key == "rate")
+	{
+		setInjectionRate(atof(value.c_str()));
+	}
+	else if (key == "outstanding")
+	{
+		setMaxOutstanding(strtoul(value.c_str(), NULL, 0));
+	}
+	else if (key == "writes")
+	{
+		setWriteFraction(atof(value.c_str()));
+	}
+	else if (key == "footprint")
+	{
+		setFootprint(strtoull(value.c_str(), NULL, 0) << 20);
+	}
+	else if (key == "stride")
+	{
+		stride = strtoull(value.c_str(), NULL, 0);
+		if (stride == 0)
+		{
+			ERROR("Stride must be non-zero");
+			exit(-1);
+		}
+	}
+	else if (key == "rows")
+	{
+		numHotRows = strtoul(value.c_str(), NULL, 0);
+		if (numHotRows == 0)
+		{
+			ERROR("Need at least one hot row");
+			exit(-1);
+		}
+		hotRowAddresses.clear();
+	}
+	else if (key == "seed")
+	{
+		setSeed(strtoull(value.c_str(), NULL, 0));
+	}
+	else
+	{
+		ERROR("Unknown traffic generator option '"<<key<<"'");
+		exit(-1);
+	}
+}
+
+void TrafficGenerator::setInjectionRate(double requestsPerCycle)
+{
+	if (requestsPerCycle <= 0.0)
+	{
+		ERROR("Injection rate must be positive (got "<<requestsPerCycle<<")");
+		exit(-1);
+	}
+	injectionRate = requestsPerCycle;
+}
+
+double TrafficGenerator::getInjectionRate() const
+{
+	return injectionRate;
+}
+
+void TrafficGenerator::setMaxOutstanding(unsigned maxOutstanding_)
+{
+	maxOutstanding = maxOutstanding_;
+}
+
+void TrafficGenerator::setWriteFraction(double fraction)
+{
+	if (fraction < 0.0 || fraction > 1.0)
+	{
+		ERROR("Write fraction must be between 0 and 1 (got "<<fraction<<")");
+		exit(-1);
+	}
+	writeFraction = fraction;
+}
+
+void TrafficGenerator::setFootprint(uint64_t bytes)
+{
+	// keep everything aligned to whole transactions
+	bytes = (bytes / TRANSACTION_SIZE) * TRANSACTION_SIZE;
+	if (bytes == 0 || bytes > memoryBytes)
+	{
+		ERROR("Footprint of "<<bytes<<" bytes doesn't fit in a "<<memoryBytes<<" byte memory system");
+		exit(-1);
+	}
+	footprint = bytes;
+	readCursor = 0;
+	writeCursor = 0;
+}
+
+void TrafficGenerator::setSeed(uint64_t seed)
+{
+	// xorshift gets stuck at zero, so don't allow that as a state
+	randomState = (seed == 0) ? 0x9E3779B97F4A7C15ULL : seed;
+	hotRowAddresses.clear();
+}
+
+//xorshift64* -- fast and good enough for picking addresses
+uint64_t TrafficGenerator::nextRandom()
+{
+	randomState ^= randomState >> 12;
+	randomState ^= randomState << 25;
+	randomState ^= randomState >> 27;
+	return randomState * 2685821657736338717ULL;
+}
+
+/**
+ * The address mapping is just a permutation of address bits, so rather than
+ * writing an inverse for every scheme we find out which physical address bit
+ * lands in which bit of which field by mapping each address bit on its own. 
+ * With that, composeAddress() can build an address for any rank/bank/row/col
+ * regardless of the ADDRESS_MAPPING_SCHEME in use. 
+ **/
+void TrafficGenerator::mapAddressBits()
+{
+	chanBits = vector<unsigned>(NUM_CHANS_LOG, 0);
+	rankBits = vector<unsigned>(NUM_RANKS_LOG, 0);
+	bankBits = vector<unsigned>(NUM_BANKS_LOG, 0);
+	rowBits = vector<unsigned>(NUM_ROWS_LOG, 0);
+	colBits = vector<unsigned>(NUM_COLS_LOG - COL_LOW_BIT_WIDTH, 0);
+
+	for (unsigned b=0; b<64; b++)
+	{
+		unsigned chan, rank, bank, row, col;
+		addressMapping(1ULL<<b, chan, rank, bank, row, col);
+		if (chan)
+		{
+			chanBits[dramsim_log2(chan)] = b;
+		}
+		else if (rank)
+		{
+			rankBits[dramsim_log2(rank)] = b;
+		}
+		else if (bank)
+		{
+			bankBits[dramsim_log2(bank)] = b;
+		}
+		else if (row)
+		{
+			rowBits[dramsim_log2(row)] = b;
+		}
+		else if (col)
+		{
+			colBits[dramsim_log2(col)] = b;
+		}
+	}
+}
+
+uint64_t TrafficGenerator::composeAddress(unsigned chan, unsigned rank, unsigned bank, unsigned row, unsigned col)
+{
+	uint64_t addr = 0;
+	for (size_t i=0; i<chanBits.size(); i++)
+	{
+		addr |= (uint64_t)((chan >> i) & 1) << chanBits[i];
+	}
+	for (size_t i=0; i<rankBits.size(); i++)
+	{
+		addr |= (uint64_t)((rank >> i) & 1) << rankBits[i];
+	}
+	for (size_t i=0; i<bankBits.size(); i++)
+	{
+		addr |= (uint64_t)((bank >> i) & 1) << bankBits[i];
+	}
+	for (size_t i=0; i<rowBits.size(); i++)
+	{
+		addr |= (uint64_t)((row >> i) & 1) << rowBits[i];
+	}
+	for (size_t i=0; i<colBits.size(); i++)
+	{
+		addr |= (uint64_t)((col >> i) & 1) << colBits[i];
+	}
+	return addr;
+}
+
+void TrafficGenerator::pickHotRows()
+{
+	hotRowAddresses.clear();
+	for (size_t i=0; i<numHotRows; i++)
+	{
+		unsigned chan = nextRandom() % NUM_CHANS;
+		unsigned rank = nextRandom() % NUM_RANKS;
+		unsigned bank = nextRandom() % NUM_BANKS;
+		unsigned row = nextRandom() % NUM_ROWS;
+		hotRowAddresses.push_back(composeAddress(chan, rank, bank, row, 0));
+	}
+}
+
+void TrafficGenerator::nextRequest(bool &isWrite, uint64_t &addr)
+{
+	uint64_t numLines = footprint / TRANSACTION_SIZE;
+	unsigned numCols = 1 << colBits.size();
+
+	// use the top 53 bits to get a uniform double in [0,1)
+	isWrite = writeFraction > 0.0 &&
+		(double)(nextRandom() >> 11) * (1.0/9007199254740992.0) < writeFraction;
+
+	switch (type)
+	{
+		case Stream:
+			addr = readCursor;
+			readCursor = (readCursor + TRANSACTION_SIZE) % footprint;
+			break;
+		case Random:
+			addr = (nextRandom() % numLines) * TRANSACTION_SIZE;
+			break;
+		case Strided:
+			addr = readCursor;
+			readCursor = (readCursor + stride) % footprint;
+			// keep the alignment even if the stride isn't a multiple of the request size
+			addr = (addr / TRANSACTION_SIZE) * TRANSACTION_SIZE;
+			break;
+		case BankConflict:
+			// hammer a single bank with a different row every time
+			addr = composeAddress(0, 0, 0, nextRandom() % NUM_ROWS, nextRandom() % numCols);
+			break;
+		case HotRow:
+			if (hotRowAddresses.empty())
+			{
+				pickHotRows();
+			}
+			// since the fields don't overlap, OR-ing in the column is enough
+			addr = hotRowAddresses[nextRandom() % hotRowAddresses.size()] |
+				composeAddress(0, 0, 0, 0, nextRandom() % numCols);
+			break;
+		case Mixed:
+			// reads walk the bottom half of the footprint, writes the top half
+			if (isWrite)
+			{
+				addr = footprint/2 + writeCursor;
+				writeCursor = (writeCursor + TRANSACTION_SIZE) % (footprint/2);
+			}
+			else
+			{
+				addr = readCursor;
+				readCursor = (readCursor + TRANSACTION_SIZE) % (footprint/2);
+			}
+			addr = (addr / TRANSACTION_SIZE) * TRANSACTION_SIZE;
+			break;
+	}
+}
+
+void TrafficGenerator::update()
+{
+	uint64_t outstanding = (readsIssued - readsCompleted) + (writesIssued - writesCompleted);
+
+	injectionCredit += injectionRate;
+	while (injectionCredit >= 1.0)
+	{
+		if (maxOutstanding > 0 && outstanding >= maxOutstanding)
+		{
+			break;
+		}
+		// hang on to the request until the memory system takes it so that
+		// backpressure doesn't change the address pattern
+		if (!pendingRequest)
+		{
+			nextRequest(pendingIsWrite, pendingAddress);
+			pendingRequest = true;
+		}
+		if (!memorySystem->willAcceptTransaction(pendingAddress))
+		{
+			break;
+		}
+		memorySystem->addTransaction(pendingIsWrite, pendingAddress);
+		if (pendingIsWrite)
+		{
+			writesIssued++;
+		}
+		else
+		{
+			readsIssued++;
+		}
+		outstanding++;
+		pendingRequest = false;
+		injectionCredit -= 1.0;
+	}
+
+	// if we couldn't inject, don't let the credit pile up or we'll dump a
+	// burst of requests into the memory system once it frees up
+	if (injectionCredit >= 1.0)
+	{
+		stallCycles++;
+		injectionCredit = 1.0;
+	}
+	currentClockCycle++;
+}
+
+void TrafficGenerator::read_complete(unsigned id, uint64_t address, uint64_t done_cycle)
+{
+	readsCompleted++;
+}
+
+void TrafficGenerator::write_complete(unsigned id, uint64_t address, uint64_t done_cycle)
+{
+	writesCompleted++;
+}
+
+void TrafficGenerator::printStats()
+{
+	uint64_t issued = readsIssued + writesIssued;
+	uint64_t completed = readsCompleted + writesCompleted;
+	double cycles = (currentClockCycle > 0) ? (double)currentClockCycle : 1.0;
+
+	PRINT( " =======================================================" );
+	PRINT( " ============== Traffic Generator ["<<typeName(type)<<"] ==============" );
+	PRINT( "   Offered rate   : " << injectionRate << " requests/cycle" );
+	PRINT( "   Achieved rate  : " << (double)issued / cycles << " requests/cycle" );
+	PRINT( "   Issued         : " << issued << " (" << readsIssued << " reads, " << writesIssued << " writes)" );
+	PRINT( "   Completed      : " << completed << " (" << readsCompleted << " reads, " << writesCompleted << " writes)" );
+	PRINT( "   Stalled cycles : " << stallCycles );
+}
@@ -0,0 +1,160 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+#ifndef TRAFFICGENERATOR_H
+#define TRAFFICGENERATOR_H
+
+//TrafficGenerator.h
+//
+//Header file for the synthetic traffic generator object
+//
+
+#include "SystemConfiguration.h"
+#include "MultiChannelMemorySystem.h"
+#include "Callback.h"
+
+using namespace std;
+
+namespace DRAMSim
+{
+/*
+ * TrafficGenerator: a synthetic request source that feeds a
+ * MultiChannelMemorySystem directly instead of reading a trace file. 
+ *
+ * A generator is described by a string of the form 
+ *
+ * 	type[:key=value,key=value,...]
+ *
+ * where type is one of the following: 
+ * 	stream   - sequential cache lines through the footprint
+ * 	random   - uniformly random cache lines in the footprint
+ * 	stride   - a fixed stride (in bytes) through the footprint
+ * 	conflict - random rows of a single bank, i.e. every access is a row conflict
+ * 	hotrow   - random columns of a small set of rows, i.e. mostly row hits 
+ * 	mixed    - reads stream through one half of the footprint and writes
+ * 	           stream through the other half (like a copy loop)
+ *
+ * and the following keys are understood by all types: 
+ * 	rate=R        requests injected per cycle (default 1.0)
+ * 	outstanding=N maximum requests in flight, 0 means no limit (default 32)
+ * 	writes=F      fraction of requests that are writes (default 0, mixed=0.5)
+ * 	footprint=M   size of the region to touch in megabytes (default: all of memory)
+ * 	stride=B      bytes between requests for the stride generator (default 4096)
+ * 	rows=N        number of hot rows for the hotrow generator (default 4)
+ * 	seed=S        random seed (default 1)
+ *
+ * The generator registers its own completion callbacks with the memory system
+ * so that it can keep track of how many requests are outstanding. 
+ */
+class TrafficGenerator
+{
+public:
+	enum GeneratorType
+	{
+		Stream,
+		Random,
+		Strided,
+		BankConflict,
+		HotRow,
+		Mixed
+	};
+
+	TrafficGenerator(MultiChannelMemorySystem *memorySystem, GeneratorType type, uint64_t memoryBytes);
+	virtual ~TrafficGenerator();
+	static TrafficGenerator *fromString(const string &spec, MultiChannelMemorySystem *memorySystem, uint64_t memoryBytes);
+	static bool parseType(const string &name, GeneratorType &type);
+	static const char *typeName(GeneratorType type);
+
+	void setOption(const string &key, const string &value);
+	void setInjectionRate(double requestsPerCycle);
+	double getInjectionRate() const;
+	void setMaxOutstanding(unsigned maxOutstanding);
+	void setWriteFraction(double fraction);
+	void setFootprint(uint64_t bytes);
+	void setSeed(uint64_t seed);
+
+	// call once per CPU cycle, before the memory system's update() 
+	void update();
+	void printStats();
+
+	void read_complete(unsigned id, uint64_t address, uint64_t done_cycle);
+	void write_complete(unsigned id, uint64_t address, uint64_t done_cycle);
+
+	//fields
+	GeneratorType type;
+	uint64_t currentClockCycle;
+	uint64_t readsIssued;
+	uint64_t writesIssued;
+	uint64_t readsCompleted;
+	uint64_t writesCompleted;
+	uint64_t stallCycles;
+
+private:
+	//functions
+	void nextRequest(bool &isWrite, uint64_t &addr);
+	uint64_t nextRandom();
+	uint64_t composeAddress(unsigned chan, unsigned rank, unsigned bank, unsigned row, unsigned col);
+	void mapAddressBits();
+	void pickHotRows();
+
+	//fields
+	MultiChannelMemorySystem *memorySystem;
+	ostream &dramsim_log;
+	TransactionCompleteCB *readCB;
+	TransactionCompleteCB *writeCB;
+
+	uint64_t memoryBytes;
+	uint64_t footprint;
+	uint64_t stride;
+	unsigned numHotRows;
+	double injectionRate;
+	double writeFraction;
+	unsigned maxOutstanding;
+	uint64_t randomState;
+
+	// token bucket for the injection rate
+	double injectionCredit;
+
+	// request that was generated but couldn't be accepted by the memory system yet
+	bool pendingRequest;
+	bool pendingIsWrite;
+	uint64_t pendingAddress;
+
+	// per-pattern cursors
+	uint64_t readCursor;
+	uint64_t writeCursor;
+
+	// the address bit positions of each field, least significant first
+	vector<unsigned> chanBits, rankBits, bankBits, rowBits, colBits;
+	vector<uint64_t> hotRowAddresses;
+};
+}
+
+#endif
@@ -36,6 +36,7 @@
 
 #include "Transaction.h"
 #include "PrintMacros.h"
+#include "AddressMapping.h"
 
 using std::endl;
 using std::hex; 
@@ -46,7 +47,14 @@ namespace DRAMSim {
 Transaction::Transaction(TransactionType transType, uint64_t addr, void *dat) :
 	transactionType(transType),
 	address(addr),
-	data(dat)
+	data(dat),
+	tag(0),
+	timeCommandQueued(0),
+	timeActivated(0),
+	timeCASIssued(0),
+	refreshCycles(0),
+	prechargeCycles(0),
+	addressMapped(false)
 {}
 
 Transaction::Transaction(const Transaction &t)
@@ -55,6 +63,18 @@ Transaction::Transaction(const Transaction &t)
 	  , data(NULL)
 	  , timeAdded(t.timeAdded)
 	  , timeReturned(t.timeReturned)
+	  , tag(t.tag)
+	  , timeCommandQueued(t.timeCommandQueued)
+	  , timeActivated(t.timeActivated)
+	  , timeCASIssued(t.timeCASIssued)
+	  , refreshCycles(t.refreshCycles)
+	  , prechargeCycles(t.prechargeCycles)
+	  , addressMapped(t.addressMapped)
+	  , channel(t.channel)
+	  , rank(t.rank)
+	  , bank(t.bank)
+	  , row(t.row)
+	  , column(t.column)
 {
 	#ifndef NO_STORAGE
 	ERROR("Data storage is really outdated and these copies happen in an \n improper way, which will eventually cause problems. Please send an \n email to dramninjas [at] gmail [dot] com if you need data storage");
@@ -62,6 +82,15 @@ Transaction::Transaction(const Transaction &t)
 	#endif
 }
 
+void Transaction::mapAddress()
+{
+	if (!addressMapped)
+	{
+		addressMapping(address, channel, rank, bank, row, column);
+		addressMapped = true;
+	}
+}
+
 ostream &operator<<(ostream &os, const Transaction &t)
 {
 	if (t.transactionType == DATA_READ)
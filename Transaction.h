@@ -59,12 +59,31 @@ public:
 	void *data;
 	uint64_t timeAdded;
 	uint64_t timeReturned;
+	uint64_t tag; // opaque value of the caller, handed back with the completion
+
+	//latency breakdown (only set with LATENCY_BREAKDOWN)
+	uint64_t timeCommandQueued;
+	uint64_t timeActivated; // 0 for row buffer hits
+	uint64_t timeCASIssued;
+	uint64_t refreshCycles; // time in the command queue spent waiting for a refresh
+	uint64_t prechargeCycles; // time spent closing another row in the bank
+
+	//decoded address, set once by mapAddress() so that the controller
+	//does not run the address mapping again every cycle it looks at the
+	//transaction
+	bool addressMapped;
+	unsigned channel;
+	unsigned rank;
+	unsigned bank;
+	unsigned row;
+	unsigned column;
 
 
 	friend ostream &operator<<(ostream &os, const Transaction &t);
 	//functions
 	Transaction(TransactionType transType, uint64_t addr, void *data);
 	Transaction(const Transaction &t);
+	void mapAddress();
 
 	BusPacketType getBusPacketType()
 	{
@@ -0,0 +1,62 @@
+#!/usr/bin/python
+"""
+
+Decodes the binary bus log that DRAMSim2 writes with BUS_LOG=true (see
+BusLog.h) into the same text that DEBUG_BUS prints, with the cycle and the
+channel of each packet in front:
+
+  [1234] ch0  -- MC Issuing On Command Bus : BP [ACT] pa[0x5dec7f0] r[0] b[3] row[1502] col[799]
+
+Usage: buslog_decode.py dramsim.buslog [channel]
+
+If a channel is given, only the packets of that channel are printed.
+
+"""
+
+import struct
+import sys
+
+HEADER = struct.Struct('=8sII')
+RECORD = struct.Struct('=QQIIHBBBBH')
+
+# BusLog::Event
+EVENTS = [' -- MC Issuing On Command Bus : ',
+          ' -- MC Issuing On Data Bus    : ',
+          ' -- MC Receiving From Data Bus : ',
+          ' -- R%d Receiving On Bus    : ',
+          ' -- R%d Issuing On Data Bus : ']
+
+# BusPacketType
+PACKET_TYPES = ['READ', 'READ_P', 'WRITE', 'WRITE_P', 'ACT', 'PRE', 'REF', 'DATA']
+
+def main():
+	if len(sys.argv) < 2:
+		sys.exit("Usage: %s BUSLOG [CHANNEL]" % sys.argv[0])
+	channelFilter = None
+	if len(sys.argv) > 2:
+		channelFilter = int(sys.argv[2])
+
+	f = open(sys.argv[1], 'rb')
+	magic, version, recordSize = HEADER.unpack(f.read(HEADER.size))
+	if magic != b'DRAMBUSL' or version != 1:
+		sys.exit("%s is not a DRAMSim2 bus log" % sys.argv[1])
+	if recordSize != RECORD.size:
+		sys.exit("Unexpected record size %d" % recordSize)
+
+	out = sys.stdout
+	while True:
+		data = f.read(RECORD.size * 4096)
+		if not data:
+			break
+		for offset in range(0, len(data) - RECORD.size + 1, RECORD.size):
+			cycle, address, row, column, bank, rank, channel, event, packetType, reserved = RECORD.unpack_from(data, offset)
+			if channelFilter is not None and channel != channelFilter:
+				continue
+			prefix = EVENTS[event]
+			if '%d' in prefix:
+				prefix = prefix % rank
+			line = "[%d] ch%d %sBP [%s] pa[0x%x] r[%d] b[%d] row[%d] col[%d]" % (cycle, channel, prefix, PACKET_TYPES[packetType], address, rank, bank, row, column)
+			out.write(line + "\n")
+
+if __name__ == '__main__':
+	main()
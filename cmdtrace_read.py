@@ -0,0 +1,108 @@
+#!/usr/bin/python
+"""
+
+Reads the per-channel DRAM command traces that DRAMSim2 writes with
+COMMAND_TRACE=raw or COMMAND_TRACE=gzip (see CommandTrace.h).
+
+Usage: cmdtrace_read.py [-s] dramsim.ch0.cmdtrace[.gz] ...
+
+By default every command is printed as
+
+  CYCLE CHANNEL COMMAND RANK BANK ROW COLUMN
+
+With -s only a summary is printed: the number of each kind of command per
+channel, per rank and bank, and the cycle of the last command.
+
+"""
+
+import gzip
+import sys
+
+# BusPacketType
+COMMANDS = ['READ', 'READ_P', 'WRITE', 'WRITE_P', 'ACT', 'PRE', 'REF', 'DATA']
+
+class Reader:
+	def __init__(self, filename):
+		if filename.endswith('.gz'):
+			self.f = gzip.open(filename, 'rb')
+		else:
+			self.f = open(filename, 'rb')
+		self.data = bytearray()
+		self.pos = 0
+		if bytes(self.read(8)) != b'DRAMCMDT':
+			sys.exit("%s is not a DRAMSim2 command trace" % filename)
+		self.version = self.varint()
+		if self.version != 1:
+			sys.exit("%s: unsupported version %d" % (filename, self.version))
+		self.channel = self.varint()
+		self.tCK = self.varint() / 1000.0
+
+	def fill(self, n):
+		while len(self.data) - self.pos < n:
+			chunk = self.f.read(1 << 20)
+			if not chunk:
+				return False
+			self.data = self.data[self.pos:] + bytearray(chunk)
+			self.pos = 0
+		return True
+
+	def read(self, n):
+		if not self.fill(n):
+			raise EOFError
+		out = self.data[self.pos:self.pos + n]
+		self.pos += n
+		return out
+
+	def varint(self):
+		value = 0
+		shift = 0
+		while True:
+			b = self.read(1)[0]
+			value |= (b & 0x7f) << shift
+			if b < 0x80:
+				return value
+			shift += 7
+
+	def commands(self):
+		cycle = 0
+		while self.fill(1):
+			cycle += self.varint()
+			command = self.read(1)[0]
+			rank = self.varint()
+			bank = self.varint()
+			row = self.varint()
+			column = self.varint()
+			yield cycle, command, rank, bank, row, column
+
+def main():
+	args = sys.argv[1:]
+	summary = False
+	if args and args[0] == '-s':
+		summary = True
+		args = args[1:]
+	if not args:
+		sys.exit("Usage: %s [-s] CMDTRACE ..." % sys.argv[0])
+
+	out = sys.stdout
+	for filename in args:
+		reader = Reader(filename)
+		counts = {}
+		banks = {}
+		lastCycle = 0
+		for cycle, command, rank, bank, row, column in reader.commands():
+			if summary:
+				counts[command] = counts.get(command, 0) + 1
+				key = (rank, bank)
+				banks.setdefault(key, [0] * len(COMMANDS))[command] += 1
+				lastCycle = cycle
+			else:
+				out.write("%d %d %s %d %d %d %d\n" % (cycle, reader.channel, COMMANDS[command], rank, bank, row, column))
+		if summary:
+			out.write("== %s : channel %d, tCK=%gns, last command at cycle %d\n" % (filename, reader.channel, reader.tCK, lastCycle))
+			out.write("   " + " ".join(["%s=%d" % (COMMANDS[c], counts[c]) for c in sorted(counts)]) + "\n")
+			for rank, bank in sorted(banks):
+				perBank = banks[(rank, bank)]
+				out.write("   r%d b%d : " % (rank, bank) + " ".join(["%s=%d" % (COMMANDS[c], perBank[c]) for c in range(len(COMMANDS)) if perBank[c] > 0]) + "\n")
+
+if __name__ == '__main__':
+	main()